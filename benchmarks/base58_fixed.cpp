@@ -0,0 +1,61 @@
+#include <array>
+#include <string>
+#include <vector>
+
+#include <base58/base58.hpp>
+
+#include "benchmark.hpp"
+
+int main()
+{
+    std::array<unsigned char, 32> hash;
+    std::array<unsigned char, 64> signature;
+    for (std::size_t i = 0; i < signature.size(); i++)
+    {
+        signature[i] = static_cast<unsigned char>(i * 37 + 11);
+    }
+    std::copy(signature.begin(), signature.begin() + hash.size(), hash.begin());
+    const std::string hash_b58 = base58::encode(hash.data(), hash.data() + hash.size());
+    const std::string signature_b58 = base58::encode(signature.data(), signature.data() + signature.size());
+
+    char encoded[base58::ENCODED_64_MAX_SIZE];
+    std::vector<unsigned char> decoded;
+    std::array<unsigned char, 64> decoded_fixed;
+
+    ntb::benchmark::run("encode: 32 bytes, generic", 100000, [&]()
+                        { ntb::benchmark::do_not_optimize(base58::encode(hash.data(), hash.data() + hash.size())); });
+    ntb::benchmark::run("encode_32: into a stack buffer", 100000, [&]()
+                        {
+        ntb::benchmark::do_not_optimize(base58::encode_32(hash.data(), encoded));
+        ntb::benchmark::do_not_optimize(encoded); });
+    ntb::benchmark::run("decode: 32 bytes, generic", 100000, [&]()
+                        {
+        base58::decode(hash_b58, decoded);
+        ntb::benchmark::do_not_optimize(decoded); });
+    ntb::benchmark::run("decode_32", 100000, [&]()
+                        {
+        ntb::benchmark::do_not_optimize(base58::decode_32(hash_b58, decoded_fixed.data()));
+        ntb::benchmark::do_not_optimize(decoded_fixed); });
+
+    ntb::benchmark::run("encode: 64 bytes, generic", 100000, [&]()
+                        { ntb::benchmark::do_not_optimize(base58::encode(signature.data(), signature.data() + signature.size())); });
+    ntb::benchmark::run("encode_64: into a stack buffer", 100000, [&]()
+                        {
+        ntb::benchmark::do_not_optimize(base58::encode_64(signature.data(), encoded));
+        ntb::benchmark::do_not_optimize(encoded); });
+    ntb::benchmark::run("decode: 64 bytes, generic", 100000, [&]()
+                        {
+        base58::decode(signature_b58, decoded);
+        ntb::benchmark::do_not_optimize(decoded); });
+    ntb::benchmark::run("decode_64", 100000, [&]()
+                        {
+        ntb::benchmark::do_not_optimize(base58::decode_64(signature_b58, decoded_fixed.data()));
+        ntb::benchmark::do_not_optimize(decoded_fixed); });
+
+    // Both paths must agree
+    const bool hash_ok = base58::encode_32(hash.data()) == hash_b58 && base58::decode_32(hash_b58, decoded_fixed.data()) &&
+                         std::equal(hash.begin(), hash.end(), decoded_fixed.begin());
+    const bool signature_ok = base58::encode_64(signature.data()) == signature_b58 && base58::decode_64(signature_b58, decoded_fixed.data()) &&
+                              decoded_fixed == signature;
+    return (hash_ok && signature_ok) ? 0 : 1;
+}
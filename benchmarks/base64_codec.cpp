@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <base58/base64.hpp>
+
+#include "benchmark.hpp"
+
+namespace
+{
+    // Roughly the args or view result of a state heavy contract call
+    constexpr std::size_t PAYLOAD_SIZE = 256 * 1024;
+
+    std::string backend_name(base64::Backend backend)
+    {
+        switch (backend)
+        {
+        case base64::Backend::Avx2:
+            return "AVX2";
+        case base64::Backend::Ssse3:
+            return "SSSE3";
+        default:
+            return "scalar";
+        }
+    }
+}
+
+int main()
+{
+    std::vector<unsigned char> payload(PAYLOAD_SIZE);
+    for (std::size_t i = 0; i < payload.size(); i++)
+    {
+        payload[i] = static_cast<unsigned char>(i * 131 + (i >> 7));
+    }
+    std::string encoded(base64::encoded_size(payload.size()), '\0');
+    std::vector<unsigned char> decoded(base64::decoded_max_size(encoded.size()));
+
+    std::cout << "Detected: " << backend_name(base64::backend()) << " backend" << std::endl;
+
+    std::string reference;
+    for (const auto backend : {base64::Backend::Scalar, base64::Backend::Ssse3, base64::Backend::Avx2})
+    {
+        if (!base64::is_supported(backend))
+        {
+            continue;
+        }
+        base64::set_backend(backend);
+        ntb::benchmark::run(backend_name(backend) + ": encode 256 KiB into a buffer", 200, [&]()
+                            {
+            base64::encode(payload.data(), payload.size(), encoded.data());
+            ntb::benchmark::do_not_optimize(encoded); });
+        ntb::benchmark::run(backend_name(backend) + ": decode 256 KiB into a buffer", 200, [&]()
+                            { ntb::benchmark::do_not_optimize(base64::decode(encoded.data(), encoded.size(), decoded.data())); });
+
+        // Every backend must produce the same encoding and get the payload back
+        if (reference.empty())
+        {
+            reference = encoded;
+        }
+        if (encoded != reference || !std::equal(payload.begin(), payload.end(), decoded.begin()))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include <vector>
+
+#include <ntb/signer.hpp>
+
+#include "benchmark.hpp"
+
+namespace
+{
+    constexpr std::size_t MESSAGE_COUNT = 4096;
+    // Roughly the size of a Borsh encoded FunctionCall transaction
+    constexpr std::size_t MESSAGE_SIZE = 200;
+}
+
+int main()
+{
+    std::vector<std::vector<uint8_t>> messages(MESSAGE_COUNT, std::vector<uint8_t>(MESSAGE_SIZE));
+    std::vector<ntb::SignerMessage> views;
+    for (std::size_t i = 0; i < MESSAGE_COUNT; i++)
+    {
+        for (std::size_t j = 0; j < MESSAGE_SIZE; j++)
+        {
+            messages[i][j] = static_cast<uint8_t>(i * 7 + j);
+        }
+        views.push_back({messages[i].data(), messages[i].size()});
+    }
+    std::vector<std::array<uint8_t, 64>> signatures(MESSAGE_COUNT);
+    std::vector<std::array<uint8_t, 64>> batch_signatures(MESSAGE_COUNT);
+
+    ntb::ED25519Keypair keypair(std::array<uint8_t, 32>{1, 2, 3});
+
+    ntb::benchmark::run("sign: 4096 x 200 B one by one", 5, [&]()
+                        {
+        for (std::size_t i = 0; i < MESSAGE_COUNT; i++)
+        {
+            signatures[i] = keypair.sign(views[i].data, views[i].size);
+        }
+        ntb::benchmark::do_not_optimize(signatures); });
+
+    for (const std::size_t threads : {1, 2, 4, 0})
+    {
+        keypair.set_thread_pool(std::make_shared<ntb::ThreadPool>(threads));
+        const std::string name = "sign_batch: 4096 x 200 B, " + (threads ? std::to_string(threads) : std::string("all")) + " workers";
+        ntb::benchmark::run(name, 5, [&]()
+                            {
+            keypair.sign_batch(views.data(), views.size(), batch_signatures.data());
+            ntb::benchmark::do_not_optimize(batch_signatures); });
+    }
+
+    // Batch signing must not change the signatures
+    return (batch_signatures == signatures) ? 0 : 1;
+}
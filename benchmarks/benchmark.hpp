@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+// Replaces the global allocation functions: include from exactly one translation unit per benchmark
+namespace ntb::benchmark
+{
+    inline std::atomic<std::size_t> allocations = 0;
+}
+
+void *operator new(std::size_t size)
+{
+    ntb::benchmark::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace ntb::benchmark
+{
+    // Returns the average heap allocations per iteration
+    template <class Func>
+    double run(const std::string &name, std::size_t iterations, Func &&func)
+    {
+        func(); // warmup, lets reused buffers reach their final capacity
+
+        const std::size_t allocations_before = allocations.load();
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            func();
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const std::size_t allocations_after = allocations.load();
+
+        const double ns_per_op = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / iterations;
+        const double allocations_per_op = static_cast<double>(allocations_after - allocations_before) / iterations;
+        std::cout << std::left << std::setw(48) << name
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(1) << ns_per_op << " ns/op"
+                  << std::setw(10) << std::setprecision(2) << allocations_per_op << " allocs/op" << std::endl;
+        return allocations_per_op;
+    }
+
+    // Keeps the optimizer from discarding benchmarked results
+    template <class T>
+    void do_not_optimize(const T &value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void *sink;
+        sink = &value;
+#endif
+    }
+}
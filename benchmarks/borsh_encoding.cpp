@@ -0,0 +1,67 @@
+#include <string>
+#include <vector>
+
+#include <borsh/borsh.hpp>
+
+#include <ntb/schemas.hpp>
+
+#include "benchmark.hpp"
+
+namespace
+{
+    void run_encoders(const std::string &label, const ntb::schemas::SignedTransaction &signed_transaction, std::size_t iterations)
+    {
+        std::cout << label << ": " << BorshEncoder::EncodedSize(signed_transaction) << " bytes" << std::endl;
+
+        ntb::benchmark::run("  Encode (fresh encoder)", iterations, [&]()
+                            {
+            BorshEncoder encoder;
+            encoder.Encode(signed_transaction);
+            ntb::benchmark::do_not_optimize(encoder.GetBuffer()); });
+
+        ntb::benchmark::run("  EncodeExact (fresh encoder)", iterations, [&]()
+                            {
+            BorshEncoder encoder;
+            encoder.EncodeExact(signed_transaction);
+            ntb::benchmark::do_not_optimize(encoder.GetBuffer()); });
+
+        std::vector<uint8_t> buffer;
+        ntb::benchmark::run("  EncodeExact (reused buffer)", iterations, [&]()
+                            {
+            buffer.clear();
+            BorshEncoder encoder(buffer);
+            encoder.EncodeExact(signed_transaction);
+            ntb::benchmark::do_not_optimize(buffer); });
+    }
+}
+
+int main()
+{
+    const ntb::schemas::Signature signature{ntb::schemas::KeyType::ED25519, {}};
+
+    const ntb::schemas::Transaction add_keys_transaction{
+        "sender.testnet",
+        ntb::schemas::ED25519PublicKey{},
+        42,
+        "sender.testnet",
+        {},
+        std::vector<ntb::schemas::Action>(4, ntb::schemas::AddKey{ntb::schemas::ED25519PublicKey{}, ntb::schemas::AccessKey{0, ntb::schemas::FullAccessPermission{}}}),
+    };
+    run_encoders("SignedTransaction with 4 AddKey actions", {add_keys_transaction, signature}, 200000);
+
+    const std::string args = R"({"message":"hello from the borsh benchmark"})";
+    const ntb::schemas::Transaction function_call_transaction{
+        "sender.testnet",
+        ntb::schemas::ED25519PublicKey{},
+        42,
+        "receiver.testnet",
+        {},
+        {
+            ntb::schemas::Transfer{ntb::uint128::multiply(1000000000000, 1000000000000)},
+            ntb::schemas::FunctionCall{"set_greeting", std::vector<uint8_t>(args.begin(), args.end()), 30000000000000, 0},
+        },
+    };
+    run_encoders("SignedTransaction with Transfer and FunctionCall", {function_call_transaction, signature}, 2000);
+
+    return 0;
+}
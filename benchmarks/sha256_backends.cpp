@@ -0,0 +1,67 @@
+#include <string>
+#include <vector>
+
+#include <sha256/sha256.hpp>
+
+#include "benchmark.hpp"
+
+namespace
+{
+    constexpr std::size_t MESSAGE_COUNT = 256;
+    // Roughly the size of a Borsh encoded FunctionCall transaction
+    constexpr std::size_t MESSAGE_SIZE = 200;
+
+    std::string backend_name(sha256::Backend backend)
+    {
+        return (backend == sha256::Backend::ShaNi) ? "SHA-NI" : "scalar";
+    }
+}
+
+int main()
+{
+    std::vector<std::vector<uint8_t>> messages(MESSAGE_COUNT, std::vector<uint8_t>(MESSAGE_SIZE));
+    std::vector<const uint8_t *> message_pointers;
+    std::vector<std::size_t> message_lengths;
+    for (std::size_t i = 0; i < MESSAGE_COUNT; i++)
+    {
+        for (std::size_t j = 0; j < MESSAGE_SIZE; j++)
+        {
+            messages[i][j] = static_cast<uint8_t>(i * 7 + j);
+        }
+        message_pointers.push_back(messages[i].data());
+        message_lengths.push_back(MESSAGE_SIZE);
+    }
+    std::vector<sha256::hash_container> digests(MESSAGE_COUNT);
+    const std::vector<uint8_t> large_message(1 << 20, 0x5a);
+
+    std::cout << "Detected: " << backend_name(sha256::SHA256::backend()) << " backend, "
+              << (sha256::SHA256::multi_buffer_backend() == sha256::MultiBufferBackend::Avx2 ? "AVX2" : "sequential") << " multi-buffer" << std::endl;
+
+    for (const auto backend : {sha256::Backend::Scalar, sha256::Backend::ShaNi})
+    {
+        if (!sha256::SHA256::is_supported(backend))
+        {
+            continue;
+        }
+        sha256::SHA256::set_backend(backend);
+        ntb::benchmark::run(backend_name(backend) + ": 1 MiB", 20, [&]()
+                            { ntb::benchmark::do_not_optimize(sha256::SHA256::hash(large_message.data(), large_message.size())); });
+
+        sha256::SHA256::set_multi_buffer_backend(sha256::MultiBufferBackend::Sequential);
+        ntb::benchmark::run(backend_name(backend) + ": 256 x 200 B sequential", 200, [&]()
+                            {
+            sha256::SHA256::hash_many(message_pointers.data(), message_lengths.data(), MESSAGE_COUNT, digests.data());
+            ntb::benchmark::do_not_optimize(digests); });
+    }
+
+    if (sha256::SHA256::is_supported(sha256::MultiBufferBackend::Avx2))
+    {
+        sha256::SHA256::set_multi_buffer_backend(sha256::MultiBufferBackend::Avx2);
+        ntb::benchmark::run("AVX2: 256 x 200 B in 8 lanes", 200, [&]()
+                            {
+            sha256::SHA256::hash_many(message_pointers.data(), message_lengths.data(), MESSAGE_COUNT, digests.data());
+            ntb::benchmark::do_not_optimize(digests); });
+    }
+
+    return 0;
+}
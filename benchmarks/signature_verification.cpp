@@ -0,0 +1,66 @@
+#include <vector>
+
+#include <ed25519/ed25519.h>
+
+#include <ntb/signature_verifier.hpp>
+#include <ntb/signer.hpp>
+
+#include "benchmark.hpp"
+
+namespace
+{
+    constexpr std::size_t MESSAGE_COUNT = 1024;
+    // Login servers see the same wallets over and over
+    constexpr std::size_t SIGNERS_COUNT = 32;
+}
+
+int main()
+{
+    std::vector<ntb::ED25519Keypair> signers;
+    for (std::size_t i = 0; i < SIGNERS_COUNT; i++)
+    {
+        signers.emplace_back(std::array<uint8_t, 32>{static_cast<uint8_t>(i + 1)});
+    }
+
+    std::vector<std::array<uint8_t, 32>> hashes(MESSAGE_COUNT);
+    std::vector<ntb::SignatureCheck> checks;
+    for (std::size_t i = 0; i < MESSAGE_COUNT; i++)
+    {
+        const ntb::ED25519Keypair &signer = signers[i % SIGNERS_COUNT];
+        hashes[i] = ntb::nep413_payload_hash({"Sign in #" + std::to_string(i), {static_cast<uint8_t>(i)}, "app.near", std::nullopt});
+        checks.push_back({hashes[i].data(), hashes[i].size(), signer.sign(hashes[i].data(), hashes[i].size()), signer.get_public_key()});
+    }
+    // One forged signature, found by the per signature fallback of its batch
+    checks[MESSAGE_COUNT / 2].signature[10] ^= 1;
+
+    std::vector<int> expected(MESSAGE_COUNT);
+    ntb::benchmark::run("ed25519_verify: 1024 signatures one by one", 5, [&]()
+                        {
+        for (std::size_t i = 0; i < MESSAGE_COUNT; i++)
+        {
+            expected[i] = ed25519_verify(checks[i].signature.data(), checks[i].message, checks[i].message_size, checks[i].public_key.data());
+        }
+        ntb::benchmark::do_not_optimize(expected); });
+
+    ntb::SignatureVerifier verifier;
+    std::vector<bool> results;
+    ntb::benchmark::run("SignatureVerifier: 1024 signatures in batches", 5, [&]()
+                        {
+        results = verifier.verify_batch(checks);
+        ntb::benchmark::do_not_optimize(results); });
+
+    ntb::SignatureVerifier uncached_verifier({0});
+    ntb::benchmark::run("SignatureVerifier: same, no public key cache", 5, [&]()
+                        {
+        results = uncached_verifier.verify_batch(checks);
+        ntb::benchmark::do_not_optimize(results); });
+
+    for (std::size_t i = 0; i < MESSAGE_COUNT; i++)
+    {
+        if (results[i] != (expected[i] == 1))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
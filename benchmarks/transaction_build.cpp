@@ -0,0 +1,61 @@
+#include <string>
+#include <vector>
+
+#include <borsh/borsh.hpp>
+#include <nlohmann/json.hpp>
+
+#include <ntb/schemas.hpp>
+#include <ntb/signer.hpp>
+#include <ntb/transaction_builder.hpp>
+#include <ntb/transaction_template.hpp>
+
+#include "base58/base64.hpp"
+#include "sha256/sha256.hpp"
+
+#include "benchmark.hpp"
+
+int main()
+{
+    const ntb::ED25519Keypair keypair(std::array<uint8_t, 32>{1, 2, 3});
+    const std::string signer_id = "sender.testnet";
+    const std::string receiver_id = "receiver.testnet";
+    const std::array<uint8_t, 32> public_key = keypair.get_public_key();
+    const std::array<uint8_t, 32> block_hash = {42};
+    const std::string args = R"({"message":"hello from the transaction benchmark"})";
+    const std::vector<ntb::schemas::Action> actions = {
+        ntb::schemas::FunctionCall{"set_greeting", std::vector<uint8_t>(args.begin(), args.end()), 30000000000000, 0},
+    };
+    constexpr std::size_t iterations = 2000;
+
+    // What NearClient::transaction used to do for every send
+    ntb::benchmark::run("Copying build path", iterations, [&]()
+                        {
+        const ntb::schemas::Transaction transaction{signer_id, ntb::schemas::ED25519PublicKey{public_key}, 7, receiver_id, block_hash, actions};
+        BorshEncoder tx_encoder;
+        tx_encoder.EncodeExact(transaction);
+        sha256::SHA256 hasher;
+        hasher.update(tx_encoder.GetBuffer().data(), tx_encoder.GetBuffer().size());
+        const sha256::hash_container hash = hasher.digest();
+        const std::array<uint8_t, 64> signature = keypair.sign(std::vector<uint8_t>(hash.begin(), hash.end()));
+        const ntb::schemas::SignedTransaction signed_transaction{transaction, ntb::schemas::Signature{ntb::schemas::KeyType::ED25519, signature}};
+        BorshEncoder signed_tx_encoder;
+        signed_tx_encoder.EncodeExact(signed_transaction);
+        const std::string encoded = base64::encode(signed_tx_encoder.GetBuffer().data(), signed_tx_encoder.GetBuffer().size());
+        const nlohmann::json payload = {{"jsonrpc", "2.0"}, {"id", "dontcare"}, {"method", "broadcast_tx_async"}, {"params", {encoded}}};
+        ntb::benchmark::do_not_optimize(payload.dump()); });
+
+    ntb::TransactionBuilder &builder = ntb::TransactionBuilder::for_current_thread();
+    const double builder_allocations = ntb::benchmark::run("TransactionBuilder", iterations, [&]()
+                                                           {
+        builder.build(keypair, signer_id, public_key, 7, receiver_id, block_hash, actions);
+        ntb::benchmark::do_not_optimize(builder.rpc_body("broadcast_tx_async")); });
+
+    const ntb::TransactionTemplate transaction_template(signer_id, receiver_id, "set_greeting");
+    const double template_allocations = ntb::benchmark::run("TransactionTemplate", iterations, [&]()
+                                                            {
+        transaction_template.build(builder, keypair, public_key, 7, block_hash, reinterpret_cast<const uint8_t *>(args.data()), args.size(), 30000000000000, 0);
+        ntb::benchmark::do_not_optimize(builder.rpc_body("broadcast_tx_async")); });
+
+    // Fails the run if the builder paths regress to allocating
+    return builder_allocations == 0 && template_allocations == 0 ? 0 : 1;
+}
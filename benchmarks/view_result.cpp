@@ -0,0 +1,51 @@
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <ntb/view_result.hpp>
+
+#include "benchmark.hpp"
+
+int main()
+{
+    // A view function returning a 64 KiB JSON document, as a call_function query response
+    nlohmann::json view_output = nlohmann::json::array();
+    for (std::size_t i = 0; i < 1024; i++)
+    {
+        view_output.push_back({{"token_id", std::to_string(i)}, {"owner_id", "someone.near"}});
+    }
+    const std::string view_output_str = view_output.dump();
+    const std::vector<uint8_t> view_output_bytes(view_output_str.begin(), view_output_str.end());
+    const std::string body = nlohmann::json{
+        {"jsonrpc", "2.0"},
+        {"id", "dontcare"},
+        {"result", {{"block_hash", "4qkA4sUUG8opjH5Q9bL5mWJTnfR4ech879Db1BZXbx6P"}, {"block_height", 1}, {"logs", nlohmann::json::array()}, {"result", view_output_bytes}}}}
+                                 .dump();
+
+    std::vector<uint8_t> bytes;
+    ntb::benchmark::run("bytes: json tree, get<vector>", 200, [&]()
+                        {
+        const nlohmann::json response = nlohmann::json::parse(body);
+        ntb::benchmark::do_not_optimize(response["result"]["result"].get<std::vector<uint8_t>>()); });
+    ntb::benchmark::run("bytes: scan_view_result", 200, [&]()
+                        {
+        bytes.clear();
+        ntb::benchmark::do_not_optimize(ntb::scan_view_result(body, bytes));
+        ntb::benchmark::do_not_optimize(bytes); });
+
+    ntb::benchmark::run("json: tree, vector, string, parse", 200, [&]()
+                        {
+        const nlohmann::json response = nlohmann::json::parse(body);
+        const std::vector<uint8_t> result_bytes = response["result"]["result"];
+        const std::string result_str(result_bytes.begin(), result_bytes.end());
+        ntb::benchmark::do_not_optimize(nlohmann::json::parse(result_str)); });
+    ntb::benchmark::run("json: scan, parse from bytes", 200, [&]()
+                        {
+        bytes.clear();
+        ntb::scan_view_result(body, bytes);
+        ntb::benchmark::do_not_optimize(nlohmann::json::parse(bytes.begin(), bytes.end())); });
+
+    bytes.clear();
+    return (ntb::scan_view_result(body, bytes) && bytes == view_output_bytes) ? 0 : 1;
+}
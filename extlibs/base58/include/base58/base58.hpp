@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace base58
@@ -31,4 +33,26 @@ namespace base58
      */
     bool decode(const std::string& str, std::vector<unsigned char>& vchRet);
     bool decode(const std::string& str, unsigned char* vchRet);
+
+    /**
+     * Longest encodings of 32 bytes (keys, hashes) and 64 bytes (signatures, private keys).
+     */
+    constexpr size_t ENCODED_32_MAX_SIZE = 44;
+    constexpr size_t ENCODED_64_MAX_SIZE = 88;
+
+    /**
+     * Encode exactly 32 or 64 bytes without allocating.
+     * Writes at most ENCODED_32_MAX_SIZE / ENCODED_64_MAX_SIZE characters to out, without a terminator, and returns their count.
+     */
+    size_t encode_32(const unsigned char* data, char* out);
+    size_t encode_64(const unsigned char* data, char* out);
+    std::string encode_32(const unsigned char* data);
+    std::string encode_64(const unsigned char* data);
+
+    /**
+     * Decode a string that must encode exactly 32 or 64 bytes, without allocating.
+     * Unlike decode, surrounding spaces are not skipped. out is only written if decoding is successful.
+     */
+    bool decode_32(std::string_view str, unsigned char* out);
+    bool decode_64(std::string_view str, unsigned char* out);
 }
@@ -1,12 +1,41 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <string_view>
 
 namespace base64 {
 constexpr std::string_view base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Implementation of the bulk encode/decode loops, picked at runtime from what the CPU supports
+enum class Backend {
+    Scalar, // portable table loop
+    Ssse3,  // 12 bytes <-> 16 characters per step
+    Avx2,   // 24 bytes <-> 32 characters per step
+};
+
+[[nodiscard]] bool is_supported(Backend backend);
+[[nodiscard]] Backend backend();
+// Must not be called while other threads are encoding, throws std::invalid_argument if the CPU lacks the backend
+void set_backend(Backend backend);
+
 std::string encode(const std::string& data);
 std::string encode(const unsigned char* data, size_t len);
+// Length of the padded encoding of `len` bytes
+constexpr size_t encoded_size(size_t len)
+{
+    return (len + 2) / 3 * 4;
+}
+// Writes encoded_size(len) characters to `out` without allocating and returns the end of the output
+char* encode(const unsigned char* data, size_t len, char* out);
+// Upper bound of the decoded size of `len` characters, the exact size depends on the padding
+constexpr size_t decoded_max_size(size_t len)
+{
+    return len / 4 * 3;
+}
+// Decodes padded base64 into `out`, which holds at least decoded_max_size(len) bytes, without allocating.
+// Returns the end of the output, or nullptr if the input is not valid padded base64
+unsigned char* decode(const char* data, size_t len, unsigned char* out);
 std::string decode(const std::string& data);
 std::string decode(const unsigned char* data, size_t len);
-}
\ No newline at end of file
+}
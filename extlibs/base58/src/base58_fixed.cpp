@@ -0,0 +1,171 @@
+#include <base58/base58.hpp>
+
+#include <array>
+#include <stdint.h>
+#include <string.h>
+
+
+namespace base58 {
+namespace {
+constexpr char ALPHABET[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+// Numbers go through base 58^5, the largest power of 58 below 2^32, so 64-bit products never overflow
+constexpr uint32_t RADIX_5 = 58u * 58u * 58u * 58u * 58u;
+
+constexpr std::array<int8_t, 256> make_reverse_alphabet()
+{
+    std::array<int8_t, 256> table {};
+    for (size_t i = 0; i < table.size(); i++)
+        table[i] = -1;
+    for (size_t i = 0; i < 58; i++)
+        table[static_cast<unsigned char>(ALPHABET[i])] = static_cast<int8_t>(i);
+    return table;
+}
+
+constexpr std::array<int8_t, 256> REVERSE_ALPHABET = make_reverse_alphabet();
+
+template <size_t N>
+constexpr size_t max_encoded_size()
+{
+    return (N == 32) ? ENCODED_32_MAX_SIZE : ENCODED_64_MAX_SIZE;
+}
+
+template <size_t N>
+size_t encode_fixed(const unsigned char* data, char* out)
+{
+    constexpr size_t LIMBS = N / 4;
+    constexpr size_t CHUNKS = (max_encoded_size<N>() + 4) / 5;
+
+    size_t zeroes = 0;
+    while (zeroes < N && data[zeroes] == 0)
+        zeroes++;
+
+    // Big-endian 32-bit limbs, divided by 58^5 until nothing is left
+    uint32_t limbs[LIMBS];
+    for (size_t i = 0; i < LIMBS; i++)
+        limbs[i] = (uint32_t(data[4 * i]) << 24) | (uint32_t(data[4 * i + 1]) << 16) | (uint32_t(data[4 * i + 2]) << 8) | uint32_t(data[4 * i + 3]);
+
+    uint32_t chunks[CHUNKS]; // least significant first
+    size_t chunks_count = 0;
+    size_t first = zeroes / 4;
+    while (first < LIMBS && limbs[first] == 0)
+        first++;
+    while (first < LIMBS) {
+        uint64_t remainder = 0;
+        for (size_t i = first; i < LIMBS; i++) {
+            const uint64_t value = (remainder << 32) | limbs[i];
+            limbs[i] = uint32_t(value / RADIX_5);
+            remainder = value % RADIX_5;
+        }
+        chunks[chunks_count++] = uint32_t(remainder);
+        while (first < LIMBS && limbs[first] == 0)
+            first++;
+    }
+
+    char digits[CHUNKS * 5]; // least significant first
+    size_t digits_count = 0;
+    for (size_t i = 0; i < chunks_count; i++) {
+        uint32_t chunk = chunks[i];
+        for (int j = 0; j < 5; j++) {
+            digits[digits_count++] = char(chunk % 58);
+            chunk /= 58;
+        }
+    }
+    while (digits_count > 0 && digits[digits_count - 1] == 0)
+        digits_count--;
+
+    size_t size = 0;
+    for (; size < zeroes; size++)
+        out[size] = '1';
+    while (digits_count > 0)
+        out[size++] = ALPHABET[size_t(digits[--digits_count])];
+    return size;
+}
+
+template <size_t N>
+bool decode_fixed(std::string_view str, unsigned char* out)
+{
+    constexpr size_t LIMBS = N / 4;
+
+    if (str.size() > max_encoded_size<N>())
+        return false;
+    size_t zeroes = 0;
+    while (zeroes < str.size() && str[zeroes] == '1')
+        zeroes++;
+    if (zeroes > N)
+        return false;
+
+    // Apply "limbs = limbs * 58^k + group" on groups of 5 digits, the first group takes what is left over
+    uint32_t limbs[LIMBS] = {};
+    size_t group = (str.size() - zeroes) % 5;
+    if (group == 0)
+        group = 5;
+    for (size_t i = zeroes; i < str.size(); group = 5) {
+        uint32_t value = 0;
+        uint32_t multiplier = 1;
+        for (const size_t end = i + group; i < end; i++) {
+            const int8_t digit = REVERSE_ALPHABET[static_cast<unsigned char>(str[i])];
+            if (digit < 0)
+                return false;
+            value = value * 58 + uint32_t(digit);
+            multiplier *= 58;
+        }
+        uint64_t carry = value;
+        for (size_t j = LIMBS; j-- > 0;) {
+            const uint64_t product = uint64_t(limbs[j]) * multiplier + carry;
+            limbs[j] = uint32_t(product);
+            carry = product >> 32;
+        }
+        if (carry != 0)
+            return false;
+    }
+
+    unsigned char bytes[N];
+    for (size_t i = 0; i < LIMBS; i++) {
+        bytes[4 * i] = (unsigned char)(limbs[i] >> 24);
+        bytes[4 * i + 1] = (unsigned char)(limbs[i] >> 16);
+        bytes[4 * i + 2] = (unsigned char)(limbs[i] >> 8);
+        bytes[4 * i + 3] = (unsigned char)limbs[i];
+    }
+    // Each leading '1' stands for one leading zero byte, so they must match exactly
+    size_t leading = 0;
+    while (leading < N && bytes[leading] == 0)
+        leading++;
+    if (leading != zeroes)
+        return false;
+    memcpy(out, bytes, N);
+    return true;
+}
+}
+
+size_t encode_32(const unsigned char* data, char* out)
+{
+    return encode_fixed<32>(data, out);
+}
+
+size_t encode_64(const unsigned char* data, char* out)
+{
+    return encode_fixed<64>(data, out);
+}
+
+std::string encode_32(const unsigned char* data)
+{
+    char out[ENCODED_32_MAX_SIZE];
+    return std::string(out, encode_fixed<32>(data, out));
+}
+
+std::string encode_64(const unsigned char* data)
+{
+    char out[ENCODED_64_MAX_SIZE];
+    return std::string(out, encode_fixed<64>(data, out));
+}
+
+bool decode_32(std::string_view str, unsigned char* out)
+{
+    return decode_fixed<32>(str, out);
+}
+
+bool decode_64(std::string_view str, unsigned char* out)
+{
+    return decode_fixed<64>(str, out);
+}
+}
@@ -1,108 +1,46 @@
-#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
 #include <string>
 
 #include <base58/base64.hpp>
 
+#include "base64_backends.hpp"
+
 namespace base64 {
-std::string encode(const std::string& data)
+namespace {
+constexpr std::array<int8_t, 256> make_reverse_chars()
 {
-    int counter = 0;
-    uint32_t bit_stream = 0;
-    std::string encoded;
-    int offset = 0;
-    for (unsigned char c : data) {
-        auto num_val = static_cast<unsigned int>(c);
-        offset = 16 - counter % 3 * 8;
-        bit_stream += num_val << offset;
-        if (offset == 16) {
-            encoded += base64_chars.at(bit_stream >> 18 & 0x3f);
-        }
-        if (offset == 8) {
-            encoded += base64_chars.at(bit_stream >> 12 & 0x3f);
-        }
-        if (offset == 0 && counter != 3) {
-            encoded += base64_chars.at(bit_stream >> 6 & 0x3f);
-            encoded += base64_chars.at(bit_stream & 0x3f);
-            bit_stream = 0;
-        }
-        counter++;
-    }
-    if (offset == 16) {
-        encoded += base64_chars.at(bit_stream >> 12 & 0x3f);
-        encoded += "==";
+    std::array<int8_t, 256> table {};
+    for (size_t i = 0; i < table.size(); i++) {
+        table[i] = -1;
     }
-    if (offset == 8) {
-        encoded += base64_chars.at(bit_stream >> 6 & 0x3f);
-        encoded += '=';
+    for (size_t i = 0; i < base64_chars.size(); i++) {
+        table[static_cast<unsigned char>(base64_chars[i])] = static_cast<int8_t>(i);
     }
-    return encoded;
+    return table;
 }
 
-std::string encode(const unsigned char* data, size_t len)
+constexpr std::array<int8_t, 256> reverse_chars = make_reverse_chars();
+
+Backend detect_backend()
 {
-    int counter = 0;
-    uint32_t bit_stream = 0;
-    std::string encoded;
-    int offset = 0;
-    for (size_t i = 0; i < len; i++) {
-        unsigned char c = data[i];
-        auto num_val = static_cast<unsigned int>(c);
-        offset = 16 - counter % 3 * 8;
-        bit_stream += num_val << offset;
-        if (offset == 16) {
-            encoded += base64_chars.at(bit_stream >> 18 & 0x3f);
-        }
-        if (offset == 8) {
-            encoded += base64_chars.at(bit_stream >> 12 & 0x3f);
-        }
-        if (offset == 0 && counter != 3) {
-            encoded += base64_chars.at(bit_stream >> 6 & 0x3f);
-            encoded += base64_chars.at(bit_stream & 0x3f);
-            bit_stream = 0;
-        }
-        counter++;
+    if (detail::cpu_has_avx2()) {
+        return Backend::Avx2;
     }
-    if (offset == 16) {
-        encoded += base64_chars.at(bit_stream >> 12 & 0x3f);
-        encoded += "==";
-    }
-    if (offset == 8) {
-        encoded += base64_chars.at(bit_stream >> 6 & 0x3f);
-        encoded += '=';
-    }
-    return encoded;
+    return detail::cpu_has_ssse3() ? Backend::Ssse3 : Backend::Scalar;
 }
 
-std::string decode(const std::string& data)
+// Function-local so encoding from other static initializers still finds a selected backend
+std::atomic<Backend>& active_backend()
 {
-    int counter = 0;
-    uint32_t bit_stream = 0;
-    std::string decoded;
-    int offset = 0;
-    for (unsigned char c : data) {
-        auto num_val = base64_chars.find(c);
-        if (num_val != std::string::npos) {
-            offset = 18 - counter % 4 * 6;
-            bit_stream += num_val << offset;
-            if (offset == 12) {
-                decoded += static_cast<char>(bit_stream >> 16 & 0xff);
-            }
-            if (offset == 6) {
-                decoded += static_cast<char>(bit_stream >> 8 & 0xff);
-            }
-            if (offset == 0 && counter != 4) {
-                decoded += static_cast<char>(bit_stream & 0xff);
-                bit_stream = 0;
-            }
-        } else if (c != '=') {
-            return std::string();
-        }
-        counter++;
-    }
-    return decoded;
+    static std::atomic<Backend> backend = detect_backend();
+    return backend;
 }
 
-std::string decode(const unsigned char* data, size_t len)
+// Accepts '=' anywhere and missing padding, returns an empty string on other characters outside the alphabet
+std::string decode_lenient(const unsigned char* data, size_t len)
 {
     int counter = 0;
     uint32_t bit_stream = 0;
@@ -133,3 +71,142 @@ std::string decode(const unsigned char* data, size_t len)
     return decoded;
 }
 }
+
+bool is_supported(Backend backend)
+{
+    switch (backend) {
+    case Backend::Avx2:
+        return detail::cpu_has_avx2();
+    case Backend::Ssse3:
+        return detail::cpu_has_ssse3();
+    default:
+        return true;
+    }
+}
+
+Backend backend()
+{
+    return active_backend().load();
+}
+
+void set_backend(Backend backend)
+{
+    if (!is_supported(backend)) {
+        throw std::invalid_argument("base64 backend is not supported by this CPU");
+    }
+    active_backend() = backend;
+}
+
+std::string encode(const std::string& data)
+{
+    return encode(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+}
+
+std::string encode(const unsigned char* data, size_t len)
+{
+    std::string encoded(encoded_size(len), '\0');
+    encode(data, len, encoded.data());
+    return encoded;
+}
+
+char* encode(const unsigned char* data, size_t len, char* out)
+{
+    size_t i = 0;
+    switch (active_backend().load(std::memory_order_relaxed)) {
+    case Backend::Avx2:
+        i = detail::encode_avx2(data, len, out);
+        break;
+    case Backend::Ssse3:
+        i = detail::encode_ssse3(data, len, out);
+        break;
+    default:
+        break;
+    }
+    out += i / 3 * 4;
+
+    for (; i + 3 <= len; i += 3) {
+        const uint32_t bit_stream = static_cast<uint32_t>(data[i]) << 16 | static_cast<uint32_t>(data[i + 1]) << 8 | data[i + 2];
+        *out++ = base64_chars[bit_stream >> 18 & 0x3f];
+        *out++ = base64_chars[bit_stream >> 12 & 0x3f];
+        *out++ = base64_chars[bit_stream >> 6 & 0x3f];
+        *out++ = base64_chars[bit_stream & 0x3f];
+    }
+    if (i + 1 == len) {
+        const uint32_t bit_stream = static_cast<uint32_t>(data[i]) << 16;
+        *out++ = base64_chars[bit_stream >> 18 & 0x3f];
+        *out++ = base64_chars[bit_stream >> 12 & 0x3f];
+        *out++ = '=';
+        *out++ = '=';
+    } else if (i + 2 == len) {
+        const uint32_t bit_stream = static_cast<uint32_t>(data[i]) << 16 | static_cast<uint32_t>(data[i + 1]) << 8;
+        *out++ = base64_chars[bit_stream >> 18 & 0x3f];
+        *out++ = base64_chars[bit_stream >> 12 & 0x3f];
+        *out++ = base64_chars[bit_stream >> 6 & 0x3f];
+        *out++ = '=';
+    }
+    return out;
+}
+
+unsigned char* decode(const char* data, size_t len, unsigned char* out)
+{
+    if (len % 4 != 0) {
+        return nullptr;
+    }
+
+    size_t i = 0;
+    switch (active_backend().load(std::memory_order_relaxed)) {
+    case Backend::Avx2:
+        i = detail::decode_avx2(data, len, out);
+        break;
+    case Backend::Ssse3:
+        i = detail::decode_ssse3(data, len, out);
+        break;
+    default:
+        break;
+    }
+    out += i / 4 * 3;
+
+    // Every group but the last one is unpadded
+    for (; i < len; i += 4) {
+        const int32_t a = reverse_chars[static_cast<unsigned char>(data[i])];
+        const int32_t b = reverse_chars[static_cast<unsigned char>(data[i + 1])];
+        int32_t c = reverse_chars[static_cast<unsigned char>(data[i + 2])];
+        int32_t d = reverse_chars[static_cast<unsigned char>(data[i + 3])];
+        size_t size = 3;
+        if (i + 4 == len && data[i + 3] == '=') {
+            size = (data[i + 2] == '=') ? 1 : 2;
+            c = (size == 1) ? 0 : c;
+            d = 0;
+        }
+        if ((a | b | c | d) < 0) {
+            return nullptr;
+        }
+
+        const uint32_t bit_stream = static_cast<uint32_t>(a) << 18 | static_cast<uint32_t>(b) << 12 | static_cast<uint32_t>(c) << 6 | static_cast<uint32_t>(d);
+        *out++ = static_cast<unsigned char>(bit_stream >> 16);
+        if (size > 1) {
+            *out++ = static_cast<unsigned char>(bit_stream >> 8);
+        }
+        if (size > 2) {
+            *out++ = static_cast<unsigned char>(bit_stream);
+        }
+    }
+    return out;
+}
+
+std::string decode(const std::string& data)
+{
+    return decode(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+}
+
+std::string decode(const unsigned char* data, size_t len)
+{
+    std::string decoded(decoded_max_size(len), '\0');
+    unsigned char* begin = reinterpret_cast<unsigned char*>(decoded.data());
+    if (const unsigned char* end = decode(reinterpret_cast<const char*>(data), len, begin)) {
+        decoded.resize(static_cast<size_t>(end - begin));
+        return decoded;
+    }
+    return decode_lenient(data, len);
+}
+}
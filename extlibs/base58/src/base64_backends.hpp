@@ -0,0 +1,22 @@
+#ifndef BASE64_BACKENDS_H
+#define BASE64_BACKENDS_H
+
+#include <cstddef>
+
+// Bulk loops of the accelerated backends, not part of the public interface.
+// They only handle whole blocks and leave the rest, including padding, to the scalar code.
+namespace base64::detail {
+bool cpu_has_ssse3();
+bool cpu_has_avx2();
+
+// Encode whole 12 / 24 byte blocks while enough input can be read past them, return the number of bytes consumed
+size_t encode_ssse3(const unsigned char* data, size_t len, char* out);
+size_t encode_avx2(const unsigned char* data, size_t len, char* out);
+
+// Decode whole 16 / 32 character blocks while enough input follows them for the wider stores to stay in `out`.
+// Stop before the first block holding a character outside the alphabet and return the number of characters consumed
+size_t decode_ssse3(const char* data, size_t len, unsigned char* out);
+size_t decode_avx2(const char* data, size_t len, unsigned char* out);
+}
+
+#endif
@@ -0,0 +1,289 @@
+#include <cstdint>
+#include <cstdlib>
+
+#include "base64_backends.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BASE64_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// GCC and Clang only emit SSSE3/AVX2 instructions in functions that opt in, MSVC always allows the intrinsics
+#if defined(BASE64_X86) && !defined(_MSC_VER)
+#define BASE64_TARGET(features) __attribute__((target(features)))
+#else
+#define BASE64_TARGET(features)
+#endif
+
+// Vector algorithms from Wojciech Mula and Daniel Lemire, "Faster Base64 Encoding and Decoding using AVX2 Instructions"
+namespace base64::detail {
+#ifdef BASE64_X86
+namespace {
+struct CpuFeatures {
+    bool ssse3 = false;
+    bool avx2 = false;
+};
+
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t registers[4])
+{
+#if defined(_MSC_VER)
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; i++) {
+        registers[i] = static_cast<uint32_t>(values[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+BASE64_TARGET("xsave")
+uint64_t enabled_register_state()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    return __builtin_ia32_xgetbv(0);
+#endif
+}
+
+CpuFeatures detect_features()
+{
+    CpuFeatures features;
+    uint32_t registers[4] = {};
+    cpuid(0, 0, registers);
+    const uint32_t max_leaf = registers[0];
+    if (max_leaf < 1) {
+        return features;
+    }
+
+    cpuid(1, 0, registers);
+    features.ssse3 = (registers[2] & (1u << 9)) != 0;
+    const bool osxsave = (registers[2] & (1u << 27)) != 0;
+    // AVX2 also needs the OS to save the upper halves of the YMM registers on context switches
+    const bool ymm_enabled = osxsave && (enabled_register_state() & 0x6) == 0x6;
+    if (max_leaf >= 7) {
+        cpuid(7, 0, registers);
+        features.avx2 = features.ssse3 && ymm_enabled && (registers[1] & (1u << 5)) != 0;
+    }
+    return features;
+}
+
+const CpuFeatures& cpu_features()
+{
+    static const CpuFeatures features = detect_features();
+    return features;
+}
+
+// Spreads 12 bytes over 16 lanes holding one 6-bit index each
+BASE64_TARGET("ssse3")
+__m128i split_sextets(__m128i input)
+{
+    const __m128i in = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+// Maps 6-bit indices to characters by adding a per-range offset
+BASE64_TARGET("ssse3")
+__m128i sextets_to_ascii(__m128i indices)
+{
+    // 0..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12, then 0..25 -> 13
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+}
+
+// Same as sextets_to_ascii on both 128-bit lanes
+BASE64_TARGET("avx2")
+__m256i sextets_to_ascii_avx2(__m256i indices)
+{
+    __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    const __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    range = _mm256_or_si256(range, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+    const __m256i offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), indices);
+}
+
+/*
+    Maps characters to 6-bit indices. The high nibble picks the offset to add, and a bitmask indexed by the low nibble
+    tells which high nibbles are valid for it. Sets `invalid` lanes to 0xff for characters outside the alphabet.
+*/
+BASE64_TARGET("ssse3")
+__m128i ascii_to_sextets(__m128i input, __m128i& invalid)
+{
+    const __m128i high_nibbles = _mm_and_si128(_mm_srli_epi32(input, 4), _mm_set1_epi8(0x0f));
+    const __m128i low_nibbles = _mm_and_si128(input, _mm_set1_epi8(0x0f));
+    const __m128i offsets = _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i valid_high_nibbles = _mm_setr_epi8(
+        char(0xa8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8),
+        char(0xf8), char(0xf8), char(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54);
+    const __m128i high_nibble_bits = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, char(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+
+    // '/' shares its high nibble with '+' but needs another offset
+    const __m128i is_slash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+    const __m128i shift = _mm_or_si128(_mm_andnot_si128(is_slash, _mm_shuffle_epi8(offsets, high_nibbles)), _mm_and_si128(is_slash, _mm_set1_epi8(16)));
+    const __m128i allowed = _mm_and_si128(_mm_shuffle_epi8(valid_high_nibbles, low_nibbles), _mm_shuffle_epi8(high_nibble_bits, high_nibbles));
+    invalid = _mm_cmpeq_epi8(allowed, _mm_setzero_si128());
+    return _mm_add_epi8(input, shift);
+}
+
+// Same as ascii_to_sextets on both 128-bit lanes
+BASE64_TARGET("avx2")
+__m256i ascii_to_sextets_avx2(__m256i input, __m256i& invalid)
+{
+    const __m256i high_nibbles = _mm256_and_si256(_mm256_srli_epi32(input, 4), _mm256_set1_epi8(0x0f));
+    const __m256i low_nibbles = _mm256_and_si256(input, _mm256_set1_epi8(0x0f));
+    const __m256i offsets = _mm256_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i valid_high_nibbles = _mm256_setr_epi8(
+        char(0xa8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8),
+        char(0xf8), char(0xf8), char(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54,
+        char(0xa8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8), char(0xf8),
+        char(0xf8), char(0xf8), char(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54);
+    const __m256i high_nibble_bits = _mm256_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, char(0x80), 0, 0, 0, 0, 0, 0, 0, 0,
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, char(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+
+    const __m256i is_slash = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('/'));
+    const __m256i shift = _mm256_blendv_epi8(_mm256_shuffle_epi8(offsets, high_nibbles), _mm256_set1_epi8(16), is_slash);
+    const __m256i allowed = _mm256_and_si256(_mm256_shuffle_epi8(valid_high_nibbles, low_nibbles), _mm256_shuffle_epi8(high_nibble_bits, high_nibbles));
+    invalid = _mm256_cmpeq_epi8(allowed, _mm256_setzero_si256());
+    return _mm256_add_epi8(input, shift);
+}
+
+// Packs 16 lanes of 6-bit indices into 12 bytes at the bottom of the register
+BASE64_TARGET("ssse3")
+__m128i pack_sextets(__m128i sextets)
+{
+    const __m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+    const __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(words, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+}
+
+bool cpu_has_ssse3()
+{
+    return cpu_features().ssse3;
+}
+
+bool cpu_has_avx2()
+{
+    return cpu_features().avx2;
+}
+
+BASE64_TARGET("ssse3")
+size_t encode_ssse3(const unsigned char* data, size_t len, char* out)
+{
+    size_t i = 0;
+    // Each step reads 16 bytes and consumes 12
+    for (; i + 16 <= len; i += 12, out += 16) {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), sextets_to_ascii(split_sextets(input)));
+    }
+    return i;
+}
+
+BASE64_TARGET("avx2")
+size_t encode_avx2(const unsigned char* data, size_t len, char* out)
+{
+    size_t i = 0;
+    // Each step reads 28 bytes and consumes 24, 12 per 128-bit lane
+    for (; i + 28 <= len; i += 24, out += 32) {
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 12));
+        const __m256i input = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+        const __m256i shuffled = _mm256_shuffle_epi8(input, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+        const __m256i t0 = _mm256_and_si256(shuffled, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(shuffled, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), sextets_to_ascii_avx2(_mm256_or_si256(t1, t3)));
+    }
+    return i;
+}
+
+BASE64_TARGET("ssse3")
+size_t decode_ssse3(const char* data, size_t len, unsigned char* out)
+{
+    size_t i = 0;
+    // Each step stores 16 bytes but only produces 12, the 8 characters left behind it decode to at least 4 more bytes
+    for (; i + 16 + 8 <= len; i += 16, out += 12) {
+        __m128i invalid;
+        const __m128i sextets = ascii_to_sextets(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), invalid);
+        if (_mm_movemask_epi8(invalid) != 0) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), pack_sextets(sextets));
+    }
+    return i;
+}
+
+BASE64_TARGET("avx2")
+size_t decode_avx2(const char* data, size_t len, unsigned char* out)
+{
+    size_t i = 0;
+    // Each step stores 32 bytes but only produces 24, the 16 characters left behind it decode to at least 10 more bytes
+    for (; i + 32 + 16 <= len; i += 32, out += 24) {
+        __m256i invalid;
+        const __m256i sextets = ascii_to_sextets_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), invalid);
+        if (_mm256_movemask_epi8(invalid) != 0) {
+            break;
+        }
+        const __m256i pairs = _mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x01400140));
+        const __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        const __m256i lanes = _mm256_shuffle_epi8(words, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        // Moves the 12 bytes of the upper lane right after the 12 of the lower one
+        const __m256i packed = _mm256_permutevar8x32_epi32(lanes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+    }
+    return i;
+}
+#else
+bool cpu_has_ssse3()
+{
+    return false;
+}
+
+bool cpu_has_avx2()
+{
+    return false;
+}
+
+// Never selected on other architectures, set_backend rejects them
+size_t encode_ssse3(const unsigned char*, size_t, char*)
+{
+    std::abort();
+}
+
+size_t encode_avx2(const unsigned char*, size_t, char*)
+{
+    std::abort();
+}
+
+size_t decode_ssse3(const char*, size_t, unsigned char*)
+{
+    std::abort();
+}
+
+size_t decode_avx2(const char*, size_t, unsigned char*)
+{
+    std::abort();
+}
+#endif
+}
@@ -1,18 +1,26 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <cstring>
 #include <functional>
 #include <list>
 #include <map>
+#include <optional>
 #include <set>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <variant>
 #include <vector>
 
-#include <iostream>
-
 #include <borsh/visit_struct.hpp>
+#include <magic_enum/magic_enum.hpp>
 
 
 namespace BorshCppInternals {
@@ -83,8 +91,43 @@ struct is_map<std::unordered_map<T, Alloc>> {
 
 }
 
+// Non-owning view on a length-prefixed byte sequence of the decoded buffer
+struct BorshBytesView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    const uint8_t* begin() const { return data; }
+    const uint8_t* end() const { return data + size; }
+};
+
 class BorshEncoder {
 public:
+    BorshEncoder() = default;
+
+    // Appends to an external buffer, which keeps its capacity from one use to the next
+    explicit BorshEncoder(std::vector<uint8_t>& buffer)
+        : m_target(&buffer)
+    {
+    }
+
+    // Exact number of bytes Encode(value) writes, computed by running the encoder without writing anything
+    template <typename T>
+    static size_t EncodedSize(const T& value)
+    {
+        BorshEncoder size_calculator(CountingMode {});
+        size_calculator.Encode(value);
+        return size_calculator.m_size;
+    }
+
+    // Reserves the exact encoded size first so the value is written with a single allocation at most
+    template <typename T>
+    BorshEncoder& EncodeExact(const T& value)
+    {
+        std::vector<uint8_t>& buffer = Buffer();
+        buffer.reserve(buffer.size() + EncodedSize(value));
+        return Encode(value);
+    }
+
     template <typename T, typename U, typename... Pack, typename=void>
     constexpr BorshEncoder& Encode(const T& value, const U& value2, const Pack&... types)
     {
@@ -97,13 +140,16 @@ public:
     template <typename T, std::enable_if_t<std::is_integral_v<T>>* = nullptr>
     constexpr BorshEncoder& Encode(const T value)
     {
-        const size_t typeSize = sizeof(T);
-        uint8_t offset = 0;
-
-        for (size_t i = 0; i < typeSize; i++) {
-            uint8_t current_byte = (value >> offset) & 0xff;
-            push_to_buffer({ current_byte });
-            offset += 8;
+        if constexpr (std::is_same_v<T, bool>) {
+            push_byte(static_cast<uint8_t>(value));
+        } else {
+            using UnsignedT = std::make_unsigned_t<T>;
+            const UnsignedT unsigned_value = static_cast<UnsignedT>(value);
+            uint8_t bytes[sizeof(T)] = {};
+            for (size_t i = 0; i < sizeof(T); i++) {
+                bytes[i] = static_cast<uint8_t>(unsigned_value >> (i * 8));
+            }
+            push_to_buffer(bytes, sizeof(T));
         }
 
         return *this;
@@ -116,11 +162,7 @@ public:
 
         // From https://github.com/naphaso/cbor-cpp/blob/master/src/encoder.cpp
         const void* punny = &value;
-
-        for (size_t i = 0; i < sizeof(T); i++) {
-            uint8_t current_byte = *((uint8_t*)punny + i);
-            push_to_buffer({ current_byte });
-        }
+        push_to_buffer(static_cast<const uint8_t*>(punny), sizeof(T));
 
         return *this;
     }
@@ -129,8 +171,7 @@ public:
     BorshEncoder& Encode(const T& serializable_struct)
     {
         visit_struct::for_each(serializable_struct,
-            [this](const char* name, const auto& attribute) {
-                std::cout << "Encoding attribute " << name << std::endl;
+            [this]([[maybe_unused]] const char* name, const auto& attribute) {
                 Encode(attribute);
             });
 
@@ -140,7 +181,7 @@ public:
     template <typename T, std::enable_if_t<std::is_enum_v<T>>* = nullptr>
     constexpr BorshEncoder& Encode(const T enum_value)
     {
-        push_to_buffer({ static_cast<uint8_t>(enum_value)});
+        push_byte(static_cast<uint8_t>(enum_value));
 
         return *this;
     }
@@ -149,7 +190,7 @@ public:
     BorshEncoder& Encode(const T& encodable_struct)
     {
         auto bytes = visit_struct::traits::encodable<visit_struct::traits::clean_t<T>>::bytes(encodable_struct);
-        push_to_buffer(bytes);
+        push_to_buffer(bytes.data(), bytes.size());
 
         return *this;
     }
@@ -158,8 +199,25 @@ public:
     {
         // Write the size of the string as an u32 integer
         Encode(static_cast<uint32_t>(str.size()));
-        const std::vector<uint8_t> str_bytes(str.begin(), str.end());
-        push_to_buffer(str_bytes);
+        push_to_buffer(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+
+        return *this;
+    }
+
+    // Same encoding as std::string, so view-typed schemas round-trip with the owning ones
+    BorshEncoder& Encode(std::string_view str)
+    {
+        Encode(static_cast<uint32_t>(str.size()));
+        push_to_buffer(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+
+        return *this;
+    }
+
+    // Same encoding as std::vector<uint8_t>
+    BorshEncoder& Encode(const BorshBytesView& bytes)
+    {
+        Encode(static_cast<uint32_t>(bytes.size));
+        push_to_buffer(bytes.data, bytes.size);
 
         return *this;
     }
@@ -168,10 +226,8 @@ public:
     {
         const size_t size = std::strlen(str);
         // Write the size of the string as an u32 integer
-        Encode(size);
-
-        const std::vector<uint8_t> str_bytes(str, str + size);
-        push_to_buffer(str_bytes);
+        Encode(static_cast<uint32_t>(size));
+        push_to_buffer(reinterpret_cast<const uint8_t*>(str), size);
 
         return *this;
     }
@@ -185,9 +241,13 @@ public:
     template <typename T, size_t ArraySize>
     constexpr BorshEncoder& Encode(const std::array<T, ArraySize>& fixed_size_array)
     {
-        for (auto value : fixed_size_array)
-        {
-            Encode(value);
+        if constexpr (std::is_same_v<T, uint8_t>) {
+            push_to_buffer(fixed_size_array.data(), ArraySize);
+        } else {
+            for (const auto& value : fixed_size_array)
+            {
+                Encode(value);
+            }
         }
         return *this;
     }
@@ -205,10 +265,6 @@ public:
 
         static_assert(std::is_integral<U>::value || (size > 0), "The size of the c array must be a unsigned integer value");
 
-        if constexpr (std::is_array<T>::value) {
-            printf("Es array");
-        }
-
         if constexpr (std::is_integral<T>::value) {
             for (size_t i = 0; i < size; ++i) {
                 Encode(*array);
@@ -240,11 +296,25 @@ public:
     constexpr BorshEncoder& Encode(const std::vector<T>& vector)
     {
         Encode((uint32_t)vector.size());
-        for (const auto& value : vector)
-        {
-            Encode(value);
+        if constexpr (std::is_same_v<T, uint8_t>) {
+            push_to_buffer(vector.data(), vector.size());
+        } else {
+            for (const auto& value : vector)
+            {
+                Encode(value);
+            }
+        }
+
+        return *this;
+    }
+
+    template <typename T>
+    constexpr BorshEncoder& Encode(const std::optional<T>& optional_value)
+    {
+        Encode(static_cast<uint8_t>(optional_value.has_value()));
+        if (optional_value.has_value()) {
+            Encode(*optional_value);
         }
-        // Encode(std::pair { vector.data(), vector.size() });
 
         return *this;
     }
@@ -260,52 +330,262 @@ public:
 
     const std::vector<uint8_t>& GetBuffer() const
     {
-        return m_buffer;
+        return m_target ? *m_target : m_buffer;
     }
 
 private:
+    struct CountingMode {
+    };
+
     std::vector<uint8_t> m_buffer;
-    void push_to_buffer(std::vector<uint8_t> data)
+    std::vector<uint8_t>* m_target = nullptr;
+    bool m_counting = false;
+    size_t m_size = 0;
+
+    explicit BorshEncoder(CountingMode)
+        : m_counting(true)
     {
-        std::cout << "  New segment : ";
-        for (auto byte : data)
-        {
-            std::cout << static_cast<uint32_t>(byte) << ", ";
+    }
+
+    std::vector<uint8_t>& Buffer()
+    {
+        return m_target ? *m_target : m_buffer;
+    }
+
+    void push_byte(uint8_t byte)
+    {
+        if (m_counting) {
+            m_size++;
+            return;
         }
-        std::cout << std::endl;
-        m_buffer.insert(m_buffer.end(), data.begin(), data.end());
+        Buffer().push_back(byte);
     }
 
+    void push_to_buffer(const uint8_t* data, size_t size)
+    {
+        if (m_counting) {
+            m_size += size;
+            return;
+        }
+        if (size == 0) {
+            return;
+        }
+        // resize + memcpy rather than insert, which GCC 12 flags with a false -Wstringop-overflow once inlined
+        std::vector<uint8_t>& buffer = Buffer();
+        const size_t offset = buffer.size();
+        buffer.resize(offset + size);
+        std::memcpy(buffer.data() + offset, data, size);
+    }
+};
+
+// Thrown when the input is truncated or holds a value the target type cannot represent
+class BorshDecodeError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
 };
 
+// Bounds-checked decoder over a borrowed buffer, the buffer must outlive the decoder and every view it returns.
+// std::string_view and BorshBytesView fields are decoded as views into the buffer instead of copies.
 class BorshDecoder {
 public:
+    BorshDecoder(const uint8_t* data, size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    explicit BorshDecoder(const std::vector<uint8_t>& buffer)
+        : BorshDecoder(buffer.data(), buffer.size())
+    {
+    }
+
     template <typename... Types>
-    void Decode(const uint8_t* bufferBegin, Types&... retriveValues)
+    BorshDecoder& Decode(Types&... values)
     {
-        uint8_t* offset = (uint8_t*)bufferBegin;
+        (DecodeValue(values), ...);
+        return *this;
+    }
 
-        // DecodeInternal(&offset, retriveValues...);
-        (DecodeInternal<Types>(&offset, retriveValues), ...);
+    template <typename T>
+    T DecodeAs()
+    {
+        T value {};
+        DecodeValue(value);
+        return value;
     }
 
-private:
+    // Decodes a value that must span the whole buffer
     template <typename T>
-    void DecodeInternal(uint8_t** offset, T& value)
+    static T DecodeExact(const uint8_t* data, size_t size)
     {
-        if constexpr (std::is_integral<T>::value || std::is_floating_point<T>::value) {
-            // std::cout << typeid(T).name() << '\n';
-            value = *((T*)*(offset));
-            (*offset) += sizeof(T);
-        } else if constexpr (BorshCppInternals::is_string<T>::value) {
-            uint32_t strSize = *((uint32_t*)*(offset));
-            (*offset) += 4;
+        BorshDecoder decoder(data, size);
+        T value = decoder.DecodeAs<T>();
+        if (!decoder.AtEnd()) {
+            throw BorshDecodeError("Borsh input has trailing bytes");
+        }
+        return value;
+    }
+
+    size_t Offset() const
+    {
+        return m_offset;
+    }
+
+    size_t Remaining() const
+    {
+        return m_size - m_offset;
+    }
 
-            value = std::string((*offset), ((*offset) + strSize));
+    bool AtEnd() const
+    {
+        return m_offset == m_size;
+    }
 
-            (*offset) += strSize;
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+
+    const uint8_t* Take(size_t size)
+    {
+        if (size > Remaining()) {
+            throw BorshDecodeError("Borsh input is truncated");
+        }
+        const uint8_t* bytes = m_data + m_offset;
+        m_offset += size;
+        return bytes;
+    }
+
+    uint32_t TakeLength()
+    {
+        uint32_t length = 0;
+        DecodeValue(length);
+        return length;
+    }
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T>>* = nullptr>
+    void DecodeValue(T& value)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            const uint8_t byte = *Take(1);
+            if (byte > 1) {
+                throw BorshDecodeError("Invalid Borsh bool");
+            }
+            value = byte == 1;
         } else {
-            assert(false || "The type of the array is not supported");
+            using UnsignedT = std::make_unsigned_t<T>;
+            const uint8_t* bytes = Take(sizeof(T));
+            UnsignedT unsigned_value = 0;
+            for (size_t i = 0; i < sizeof(T); i++) {
+                unsigned_value |= static_cast<UnsignedT>(static_cast<UnsignedT>(bytes[i]) << (i * 8));
+            }
+            value = static_cast<T>(unsigned_value);
         }
     }
+
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>>* = nullptr>
+    void DecodeValue(T& value)
+    {
+        std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+    }
+
+    template <typename T, std::enable_if_t<std::is_enum_v<T>>* = nullptr>
+    void DecodeValue(T& enum_value)
+    {
+        const uint8_t discriminant = *Take(1);
+        const auto value = magic_enum::enum_cast<T>(static_cast<magic_enum::underlying_type_t<T>>(discriminant));
+        if (!value.has_value()) {
+            throw BorshDecodeError("Invalid Borsh enum value");
+        }
+        enum_value = *value;
+    }
+
+    template <typename T, std::enable_if_t<visit_struct::traits::is_visitable<visit_struct::traits::clean_t<T>>::value>* = nullptr>
+    void DecodeValue(T& serializable_struct)
+    {
+        visit_struct::for_each(serializable_struct,
+            [this]([[maybe_unused]] const char* name, auto& attribute) {
+                DecodeValue(attribute);
+            });
+    }
+
+    void DecodeValue(std::string& str)
+    {
+        const uint32_t size = TakeLength();
+        const uint8_t* bytes = Take(size);
+        str.assign(reinterpret_cast<const char*>(bytes), size);
+    }
+
+    void DecodeValue(std::string_view& str)
+    {
+        const uint32_t size = TakeLength();
+        str = std::string_view(reinterpret_cast<const char*>(Take(size)), size);
+    }
+
+    void DecodeValue(BorshBytesView& bytes)
+    {
+        bytes.size = TakeLength();
+        bytes.data = Take(bytes.size);
+    }
+
+    template <typename T, size_t ArraySize>
+    void DecodeValue(std::array<T, ArraySize>& fixed_size_array)
+    {
+        if constexpr (std::is_same_v<T, uint8_t>) {
+            std::memcpy(fixed_size_array.data(), Take(ArraySize), ArraySize);
+        } else {
+            for (auto& value : fixed_size_array) {
+                DecodeValue(value);
+            }
+        }
+    }
+
+    template <typename T>
+    void DecodeValue(std::vector<T>& vector)
+    {
+        const uint32_t size = TakeLength();
+        if constexpr (std::is_same_v<T, uint8_t>) {
+            const uint8_t* bytes = Take(size);
+            vector.assign(bytes, bytes + size);
+        } else {
+            vector.clear();
+            vector.reserve(std::min<size_t>(size, Remaining()));
+            for (uint32_t i = 0; i < size; i++) {
+                const size_t remaining = Remaining();
+                DecodeValue(vector.emplace_back());
+                // Like borsh-rs, zero-size elements are rejected, their count would not be bounded by the input size
+                if (i == 0 && Remaining() == remaining) {
+                    throw BorshDecodeError("Borsh vector of zero-size elements");
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    void DecodeValue(std::optional<T>& optional_value)
+    {
+        bool has_value = false;
+        DecodeValue(has_value);
+        if (has_value) {
+            DecodeValue(optional_value.emplace());
+        } else {
+            optional_value.reset();
+        }
+    }
+
+    template <typename... Args>
+    void DecodeValue(std::variant<Args...>& variant_enum)
+    {
+        const uint8_t index = *Take(1);
+        if (index >= sizeof...(Args)) {
+            throw BorshDecodeError("Invalid Borsh enum variant");
+        }
+        DecodeAlternative(variant_enum, index, std::index_sequence_for<Args...> {});
+    }
+
+    template <typename Variant, size_t... Indices>
+    void DecodeAlternative(Variant& variant_enum, uint8_t index, std::index_sequence<Indices...>)
+    {
+        ((index == Indices ? (DecodeValue(variant_enum.template emplace<Indices>()), true) : false) || ...);
+    }
 };
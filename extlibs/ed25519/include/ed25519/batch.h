@@ -0,0 +1,22 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stddef.h>
+
+#include "ge.h"
+
+/*
+    Verifies count signatures with one multi-scalar multiplication, for callers that keep
+    public keys decompressed with ge_frombytes_negate_vartime (negated_public_keys[i] belongs to public_keys[i], NULL when it failed to decode).
+
+    Sets valid[i] to 1 or 0 for every signature and returns 1 if all of them are valid.
+    When the batch equation fails, each signature is checked on its own to find the invalid ones.
+
+    Every signature is checked with the cofactored equation 8 * (s * B - h * A - R) = 0, in a batch or on its own,
+    so the answer never depends on the other signatures of the batch. It only disagrees with the cofactorless
+    ed25519_verify on signatures whose R or public key carry a small order component, which only the key owner can produce.
+*/
+int ed25519_verify_batch_decompressed(const unsigned char *const *signatures, const unsigned char *const *messages, const size_t *message_lens,
+                                      const unsigned char *const *public_keys, const ge_p3 *const *negated_public_keys, size_t count, int *valid);
+
+#endif
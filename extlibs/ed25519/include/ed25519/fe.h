@@ -10,10 +10,18 @@
     An element t, entries t[0]...t[9], represents the integer
     t[0]+2^26 t[1]+2^51 t[2]+2^77 t[3]+2^102 t[4]+...+2^230 t[9].
     Bounds on each t[i] vary depending on context.
+
+    With ED25519_FE51 (64-bit compilers with unsigned __int128), an element t,
+    entries t[0]...t[4], represents t[0]+2^51 t[1]+2^102 t[2]+2^153 t[3]+2^204 t[4]
+    and products are computed on 128-bit integers instead.
 */
 
 
+#ifdef ED25519_FE51
+typedef uint64_t fe[5];
+#else
 typedef int32_t fe[10];
+#endif
 
 
 void fe_0(fe h);
@@ -1,6 +1,9 @@
 #include "fixedint.h"
 #include "fe.h"
 
+/* Radix-2^25.5 backend, fe51.c replaces it when ED25519_FE51 is defined */
+#ifndef ED25519_FE51
+
 
 /*
     helper functions
@@ -361,91 +364,6 @@ void fe_frombytes(fe h, const unsigned char *s) {
 
 
 
-void fe_invert(fe out, const fe z) {
-    fe t0;
-    fe t1;
-    fe t2;
-    fe t3;
-    int i;
-
-    fe_sq(t0, z);
-
-    for (i = 1; i < 1; ++i) {
-        fe_sq(t0, t0);
-    }
-
-    fe_sq(t1, t0);
-
-    for (i = 1; i < 2; ++i) {
-        fe_sq(t1, t1);
-    }
-
-    fe_mul(t1, z, t1);
-    fe_mul(t0, t0, t1);
-    fe_sq(t2, t0);
-
-    for (i = 1; i < 1; ++i) {
-        fe_sq(t2, t2);
-    }
-
-    fe_mul(t1, t1, t2);
-    fe_sq(t2, t1);
-
-    for (i = 1; i < 5; ++i) {
-        fe_sq(t2, t2);
-    }
-
-    fe_mul(t1, t2, t1);
-    fe_sq(t2, t1);
-
-    for (i = 1; i < 10; ++i) {
-        fe_sq(t2, t2);
-    }
-
-    fe_mul(t2, t2, t1);
-    fe_sq(t3, t2);
-
-    for (i = 1; i < 20; ++i) {
-        fe_sq(t3, t3);
-    }
-
-    fe_mul(t2, t3, t2);
-    fe_sq(t2, t2);
-
-    for (i = 1; i < 10; ++i) {
-        fe_sq(t2, t2);
-    }
-
-    fe_mul(t1, t2, t1);
-    fe_sq(t2, t1);
-
-    for (i = 1; i < 50; ++i) {
-        fe_sq(t2, t2);
-    }
-
-    fe_mul(t2, t2, t1);
-    fe_sq(t3, t2);
-
-    for (i = 1; i < 100; ++i) {
-        fe_sq(t3, t3);
-    }
-
-    fe_mul(t2, t3, t2);
-    fe_sq(t2, t2);
-
-    for (i = 1; i < 50; ++i) {
-        fe_sq(t2, t2);
-    }
-
-    fe_mul(t1, t2, t1);
-    fe_sq(t1, t1);
-
-    for (i = 1; i < 5; ++i) {
-        fe_sq(t1, t1);
-    }
-
-    fe_mul(out, t1, t0);
-}
 
 
 
@@ -878,90 +796,6 @@ void fe_neg(fe h, const fe f) {
 }
 
 
-void fe_pow22523(fe out, const fe z) {
-    fe t0;
-    fe t1;
-    fe t2;
-    int i;
-    fe_sq(t0, z);
-
-    for (i = 1; i < 1; ++i) {
-        fe_sq(t0, t0);
-    }
-
-    fe_sq(t1, t0);
-
-    for (i = 1; i < 2; ++i) {
-        fe_sq(t1, t1);
-    }
-
-    fe_mul(t1, z, t1);
-    fe_mul(t0, t0, t1);
-    fe_sq(t0, t0);
-
-    for (i = 1; i < 1; ++i) {
-        fe_sq(t0, t0);
-    }
-
-    fe_mul(t0, t1, t0);
-    fe_sq(t1, t0);
-
-    for (i = 1; i < 5; ++i) {
-        fe_sq(t1, t1);
-    }
-
-    fe_mul(t0, t1, t0);
-    fe_sq(t1, t0);
-
-    for (i = 1; i < 10; ++i) {
-        fe_sq(t1, t1);
-    }
-
-    fe_mul(t1, t1, t0);
-    fe_sq(t2, t1);
-
-    for (i = 1; i < 20; ++i) {
-        fe_sq(t2, t2);
-    }
-
-    fe_mul(t1, t2, t1);
-    fe_sq(t1, t1);
-
-    for (i = 1; i < 10; ++i) {
-        fe_sq(t1, t1);
-    }
-
-    fe_mul(t0, t1, t0);
-    fe_sq(t1, t0);
-
-    for (i = 1; i < 50; ++i) {
-        fe_sq(t1, t1);
-    }
-
-    fe_mul(t1, t1, t0);
-    fe_sq(t2, t1);
-
-    for (i = 1; i < 100; ++i) {
-        fe_sq(t2, t2);
-    }
-
-    fe_mul(t1, t2, t1);
-    fe_sq(t1, t1);
-
-    for (i = 1; i < 50; ++i) {
-        fe_sq(t1, t1);
-    }
-
-    fe_mul(t0, t1, t0);
-    fe_sq(t0, t0);
-
-    for (i = 1; i < 2; ++i) {
-        fe_sq(t0, t0);
-    }
-
-    fe_mul(out, t0, z);
-    return;
-}
 
 
 /*
@@ -1489,3 +1323,5 @@ void fe_tobytes(unsigned char *s, const fe h) {
     s[30] = (unsigned char) (h9 >> 10);
     s[31] = (unsigned char) (h9 >> 18);
 }
+
+#endif
@@ -0,0 +1,365 @@
+#include "fixedint.h"
+#include "fe.h"
+
+/* Radix-2^51 backend, replaces fe.c when ED25519_FE51 is defined */
+#ifdef ED25519_FE51
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+#define MASK51 ((uint64_t) 0x7ffffffffffff)
+
+
+/*
+    helper functions
+*/
+static uint64_t load_8(const unsigned char *in) {
+    uint64_t result = 0;
+    int i;
+
+    for (i = 7; i >= 0; --i) {
+        result = (result << 8) | in[i];
+    }
+
+    return result;
+}
+
+static void store_8(unsigned char *out, uint64_t in) {
+    int i;
+
+    for (i = 0; i < 8; ++i) {
+        out[i] = (unsigned char) (in >> (8 * i));
+    }
+}
+
+/*
+    Carries every limb into the next one, the top carry wraps around multiplied by 19 (2^255 = 19 mod p).
+    Afterwards every limb is below 2^51, except h[0] which can exceed it by a few multiples of 19.
+*/
+static void fe_carry(fe h) {
+    uint64_t c;
+
+    c = h[0] >> 51; h[0] &= MASK51; h[1] += c;
+    c = h[1] >> 51; h[1] &= MASK51; h[2] += c;
+    c = h[2] >> 51; h[2] &= MASK51; h[3] += c;
+    c = h[3] >> 51; h[3] &= MASK51; h[4] += c;
+    c = h[4] >> 51; h[4] &= MASK51; h[0] += c * 19;
+}
+
+/* Same as fe_carry on 128-bit products */
+static void fe_carry_wide(fe h, uint128_t r0, uint128_t r1, uint128_t r2, uint128_t r3, uint128_t r4) {
+    uint64_t c;
+
+    r1 += (uint64_t) (r0 >> 51); h[0] = (uint64_t) r0 & MASK51;
+    r2 += (uint64_t) (r1 >> 51); h[1] = (uint64_t) r1 & MASK51;
+    r3 += (uint64_t) (r2 >> 51); h[2] = (uint64_t) r2 & MASK51;
+    r4 += (uint64_t) (r3 >> 51); h[3] = (uint64_t) r3 & MASK51;
+    c = (uint64_t) (r4 >> 51); h[4] = (uint64_t) r4 & MASK51;
+    h[0] += c * 19;
+    c = h[0] >> 51; h[0] &= MASK51; h[1] += c;
+}
+
+
+/*
+    h = 0
+*/
+
+void fe_0(fe h) {
+    h[0] = 0;
+    h[1] = 0;
+    h[2] = 0;
+    h[3] = 0;
+    h[4] = 0;
+}
+
+
+
+/*
+    h = 1
+*/
+
+void fe_1(fe h) {
+    h[0] = 1;
+    h[1] = 0;
+    h[2] = 0;
+    h[3] = 0;
+    h[4] = 0;
+}
+
+
+
+/*
+    h = f + g
+    Can overlap h with f or g.
+
+    Preconditions:
+       limbs of f and g below 2^52
+
+    Postconditions:
+       limbs of h below 2^51 + 2^14
+*/
+
+void fe_add(fe h, const fe f, const fe g) {
+    h[0] = f[0] + g[0];
+    h[1] = f[1] + g[1];
+    h[2] = f[2] + g[2];
+    h[3] = f[3] + g[3];
+    h[4] = f[4] + g[4];
+    fe_carry(h);
+}
+
+
+
+/*
+    Replace (f,g) with (g,g) if b == 1;
+    replace (f,g) with (f,g) if b == 0.
+
+    Preconditions: b in {0,1}.
+*/
+
+void fe_cmov(fe f, const fe g, unsigned int b) {
+    const uint64_t mask = (uint64_t) 0 - (uint64_t) b;
+
+    f[0] ^= mask & (f[0] ^ g[0]);
+    f[1] ^= mask & (f[1] ^ g[1]);
+    f[2] ^= mask & (f[2] ^ g[2]);
+    f[3] ^= mask & (f[3] ^ g[3]);
+    f[4] ^= mask & (f[4] ^ g[4]);
+}
+
+
+
+/*
+    Replace (f,g) with (g,f) if b == 1;
+    replace (f,g) with (f,g) if b == 0.
+
+    Preconditions: b in {0,1}.
+*/
+
+void fe_cswap(fe f, fe g, unsigned int b) {
+    const uint64_t mask = (uint64_t) 0 - (uint64_t) b;
+    uint64_t x;
+    int i;
+
+    for (i = 0; i < 5; ++i) {
+        x = mask & (f[i] ^ g[i]);
+        f[i] ^= x;
+        g[i] ^= x;
+    }
+}
+
+
+
+/*
+    h = f
+*/
+
+void fe_copy(fe h, const fe f) {
+    h[0] = f[0];
+    h[1] = f[1];
+    h[2] = f[2];
+    h[3] = f[3];
+    h[4] = f[4];
+}
+
+
+
+/*
+    Ignores top bit of s, like the radix-2^25.5 backend.
+*/
+
+void fe_frombytes(fe h, const unsigned char *s) {
+    h[0] = load_8(s) & MASK51;
+    h[1] = (load_8(s + 6) >> 3) & MASK51;
+    h[2] = (load_8(s + 12) >> 6) & MASK51;
+    h[3] = (load_8(s + 19) >> 1) & MASK51;
+    h[4] = (load_8(s + 24) >> 12) & MASK51;
+}
+
+
+
+/*
+    Writes the canonical encoding of h, in [0, p).
+*/
+
+void fe_tobytes(unsigned char *s, const fe h) {
+    fe t;
+    uint64_t q;
+
+    fe_copy(t, h);
+    fe_carry(t);
+    fe_carry(t);
+
+    /* t < 2^255 + 2^14 here, q = 1 exactly when t >= p, in which case t - p = t + 19 - 2^255 */
+    q = (t[0] + 19) >> 51;
+    q = (t[1] + q) >> 51;
+    q = (t[2] + q) >> 51;
+    q = (t[3] + q) >> 51;
+    q = (t[4] + q) >> 51;
+    t[0] += 19 * q;
+
+    t[1] += t[0] >> 51; t[0] &= MASK51;
+    t[2] += t[1] >> 51; t[1] &= MASK51;
+    t[3] += t[2] >> 51; t[2] &= MASK51;
+    t[4] += t[3] >> 51; t[3] &= MASK51;
+    t[4] &= MASK51;
+
+    store_8(s, t[0] | (t[1] << 51));
+    store_8(s + 8, (t[1] >> 13) | (t[2] << 38));
+    store_8(s + 16, (t[2] >> 26) | (t[3] << 25));
+    store_8(s + 24, (t[3] >> 39) | (t[4] << 12));
+}
+
+
+
+/*
+    return 1 if f is in {1,3,5,...,q-2}
+    return 0 if f is in {0,2,4,...,q-1}
+*/
+
+int fe_isnegative(const fe f) {
+    unsigned char s[32];
+
+    fe_tobytes(s, f);
+
+    return s[0] & 1;
+}
+
+
+
+/*
+    return 1 if f == 0
+    return 0 if f != 0
+*/
+
+int fe_isnonzero(const fe f) {
+    unsigned char s[32];
+    unsigned char r = 0;
+    int i;
+
+    fe_tobytes(s, f);
+
+    for (i = 0; i < 32; ++i) {
+        r |= s[i];
+    }
+
+    return r != 0;
+}
+
+
+
+/*
+    h = f * g
+    Can overlap h with f or g.
+
+    Preconditions:
+       limbs of f and g below 2^54
+
+    Postconditions:
+       limbs of h below 2^51 + 2^14
+*/
+
+void fe_mul(fe h, const fe f, const fe g) {
+    const uint64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+    const uint64_t g0 = g[0], g1 = g[1], g2 = g[2], g3 = g[3], g4 = g[4];
+    const uint64_t g1_19 = 19 * g1, g2_19 = 19 * g2, g3_19 = 19 * g3, g4_19 = 19 * g4;
+
+    const uint128_t r0 = (uint128_t) f0 * g0 + (uint128_t) f1 * g4_19 + (uint128_t) f2 * g3_19 + (uint128_t) f3 * g2_19 + (uint128_t) f4 * g1_19;
+    const uint128_t r1 = (uint128_t) f0 * g1 + (uint128_t) f1 * g0 + (uint128_t) f2 * g4_19 + (uint128_t) f3 * g3_19 + (uint128_t) f4 * g2_19;
+    const uint128_t r2 = (uint128_t) f0 * g2 + (uint128_t) f1 * g1 + (uint128_t) f2 * g0 + (uint128_t) f3 * g4_19 + (uint128_t) f4 * g3_19;
+    const uint128_t r3 = (uint128_t) f0 * g3 + (uint128_t) f1 * g2 + (uint128_t) f2 * g1 + (uint128_t) f3 * g0 + (uint128_t) f4 * g4_19;
+    const uint128_t r4 = (uint128_t) f0 * g4 + (uint128_t) f1 * g3 + (uint128_t) f2 * g2 + (uint128_t) f3 * g1 + (uint128_t) f4 * g0;
+
+    fe_carry_wide(h, r0, r1, r2, r3, r4);
+}
+
+
+
+/*
+    h = f * 121666
+    Can overlap h with f.
+*/
+
+void fe_mul121666(fe h, fe f) {
+    fe_carry_wide(h, (uint128_t) f[0] * 121666, (uint128_t) f[1] * 121666, (uint128_t) f[2] * 121666,
+                  (uint128_t) f[3] * 121666, (uint128_t) f[4] * 121666);
+}
+
+
+
+/*
+    h = -f
+*/
+
+void fe_neg(fe h, const fe f) {
+    fe zero;
+
+    fe_0(zero);
+    fe_sub(h, zero, f);
+}
+
+
+
+/*
+    h = 2^shift * f * f, with shift 0 or 1
+*/
+
+static void fe_sq_shift(fe h, const fe f, unsigned int shift) {
+    const uint64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+    const uint64_t f0_2 = 2 * f0, f1_2 = 2 * f1;
+    const uint64_t f3_19 = 19 * f3, f4_19 = 19 * f4;
+
+    const uint128_t r0 = (uint128_t) f0 * f0 + (uint128_t) f1_2 * f4_19 + (uint128_t) (2 * f2) * f3_19;
+    const uint128_t r1 = (uint128_t) f0_2 * f1 + (uint128_t) (2 * f2) * f4_19 + (uint128_t) f3 * f3_19;
+    const uint128_t r2 = (uint128_t) f0_2 * f2 + (uint128_t) f1 * f1 + (uint128_t) (2 * f3) * f4_19;
+    const uint128_t r3 = (uint128_t) f0_2 * f3 + (uint128_t) f1_2 * f2 + (uint128_t) f4 * f4_19;
+    const uint128_t r4 = (uint128_t) f0_2 * f4 + (uint128_t) f1_2 * f3 + (uint128_t) f2 * f2;
+
+    fe_carry_wide(h, r0 << shift, r1 << shift, r2 << shift, r3 << shift, r4 << shift);
+}
+
+
+
+/*
+    h = f * f
+    Can overlap h with f.
+*/
+
+void fe_sq(fe h, const fe f) {
+    fe_sq_shift(h, f, 0);
+}
+
+
+
+/*
+    h = 2 * f * f
+    Can overlap h with f.
+*/
+
+void fe_sq2(fe h, const fe f) {
+    fe_sq_shift(h, f, 1);
+}
+
+
+
+/*
+    h = f - g
+    Can overlap h with f or g.
+
+    Preconditions:
+       limbs of f below 2^54, limbs of g below 2^53 - 76
+
+    Postconditions:
+       limbs of h below 2^51 + 2^14
+*/
+
+void fe_sub(fe h, const fe f, const fe g) {
+    /* Adding 4p keeps every limb positive */
+    h[0] = (f[0] + 0x1fffffffffffb4) - g[0];
+    h[1] = (f[1] + 0x1ffffffffffffc) - g[1];
+    h[2] = (f[2] + 0x1ffffffffffffc) - g[2];
+    h[3] = (f[3] + 0x1ffffffffffffc) - g[3];
+    h[4] = (f[4] + 0x1ffffffffffffc) - g[4];
+    fe_carry(h);
+}
+
+#endif
@@ -0,0 +1,427 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "ed25519.h"
+#include "batch.h"
+#include "sha512.h"
+#include "ge.h"
+#include "sc.h"
+
+/* Below this many signatures the multi-scalar multiplication costs more than checking them one by one */
+#define BATCH_MIN_SIZE 8
+
+/*
+    helper functions
+*/
+static void ge_p3_add_p3(ge_p3 *r, const ge_p3 *p, const ge_p3 *q) {
+    ge_p1p1 t;
+    ge_cached c;
+
+    ge_p3_to_cached(&c, q);
+    ge_add(&t, p, &c);
+    ge_p1p1_to_p3(r, &t);
+}
+
+/* r = 2^n * r */
+static void ge_p3_dbl_n(ge_p3 *r, unsigned int n) {
+    ge_p1p1 t;
+    ge_p2 p;
+    unsigned int i;
+
+    ge_p3_to_p2(&p, r);
+    for (i = 1; i < n; ++i) {
+        ge_p2_dbl(&t, &p);
+        ge_p1p1_to_p2(&p, &t);
+    }
+    ge_p2_dbl(&t, &p);
+    ge_p1p1_to_p3(r, &t);
+}
+
+static int ge_p3_is_identity(const ge_p3 *p) {
+    fe t;
+
+    fe_sub(t, p->Y, p->Z);
+    return !fe_isnonzero(p->X) && !fe_isnonzero(t);
+}
+
+/*
+    8 * (s * B - h * A - R) = 0, the batch equation for a single signature, so a signature gets the same
+    answer alone as in any batch. negated_public_key and negated_R are -A and -R.
+*/
+static int verify_cofactored(const unsigned char *signature, const unsigned char *hram, const ge_p3 *negated_public_key, const ge_p3 *negated_R) {
+    ge_p2 sB_minus_hA;
+    ge_p1p1 t;
+    ge_p3 sum;
+
+    ge_double_scalarmult_vartime(&sB_minus_hA, hram, negated_public_key, signature + 32);
+    /* (X : Y : Z) as a completed point with T = Z */
+    fe_copy(t.X, sB_minus_hA.X);
+    fe_copy(t.Y, sB_minus_hA.Y);
+    fe_copy(t.Z, sB_minus_hA.Z);
+    fe_copy(t.T, sB_minus_hA.Z);
+    ge_p1p1_to_p3(&sum, &t);
+    ge_p3_add_p3(&sum, &sum, negated_R);
+    ge_p3_dbl_n(&sum, 3);
+    return ge_p3_is_identity(&sum);
+}
+
+/*
+    ed25519_verify compares R with a canonical encoding, so R must be canonical here too:
+    y below p, and no sign bit when x = 0 (y = 1 or y = -1)
+*/
+static int is_canonical_point(const unsigned char *s) {
+    int i;
+    int is_one = (s[0] == 1);
+    int is_minus_one = (s[0] == 0xec);
+    int top_ones = 1;
+
+    for (i = 1; i < 31; ++i) {
+        is_one &= (s[i] == 0);
+        is_minus_one &= (s[i] == 0xff);
+        top_ones &= (s[i] == 0xff);
+    }
+    is_one &= ((s[31] & 0x7f) == 0);
+    is_minus_one &= ((s[31] & 0x7f) == 0x7f);
+    top_ones &= ((s[31] & 0x7f) == 0x7f);
+
+    if (top_ones && s[0] >= 0xed) {
+        return 0;
+    }
+    if ((is_one || is_minus_one) && (s[31] & 0x80)) {
+        return 0;
+    }
+    return 1;
+}
+
+/*
+    Signed base 2^width digits of a scalar below 2^255, in [-2^(width - 1), 2^(width - 1)],
+    least significant first, windows digits written
+*/
+static void scalar_signed_digits(short *digits, const unsigned char *s, unsigned int width, unsigned int windows) {
+    const int radix = 1 << width;
+    int carry = 0;
+    unsigned int w;
+
+    for (w = 0; w < windows; ++w) {
+        const unsigned int bit = w * width;
+        unsigned int v = 0;
+        int digit;
+
+        if (bit < 256) {
+            const unsigned int byte = bit >> 3;
+
+            v = s[byte];
+            if (byte + 1 < 32) {
+                v |= (unsigned int) s[byte + 1] << 8;
+            }
+            v = (v >> (bit & 7)) & (unsigned int) (radix - 1);
+        }
+
+        digit = (int) v + carry;
+        carry = (digit + radix / 2) >> width;
+        digits[w] = (short) (digit - carry * radix);
+    }
+}
+
+/* Window width minimizing additions for count points: one per point and two per bucket, in every window */
+static unsigned int window_width(size_t count) {
+    unsigned int best_width = 2;
+    size_t best_cost = (size_t) -1;
+    unsigned int width;
+
+    for (width = 2; width <= 9; ++width) {
+        const size_t cost = (256 / width + 1) * (count + ((size_t) 1 << width));
+
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_width = width;
+        }
+    }
+    return best_width;
+}
+
+/*
+    r = sum(scalars[i] * points[i]), Pippenger's bucket method on signed digits
+    Returns -1 if the buckets could not be allocated.
+*/
+static int multiscalar_mul(ge_p3 *r, const ge_p3 *points, const ge_cached *cached, const unsigned char (*scalars)[32], size_t count) {
+    const unsigned int width = window_width(count);
+    /* One more window than 256 / width for the final carry */
+    const unsigned int windows = 256 / width + 1;
+    const size_t buckets_count = ((size_t) 1 << (width - 1)) + 1;
+    ge_p3 *buckets = (ge_p3 *) malloc(buckets_count * sizeof(ge_p3));
+    unsigned char *used = (unsigned char *) malloc(buckets_count);
+    short *digits = (short *) malloc(count * windows * sizeof(short));
+    ge_p1p1 t;
+    ge_p3 running;
+    ge_p3 window_sum;
+    int started = 0;
+    unsigned int w;
+    size_t i;
+    size_t d;
+
+    if (buckets == NULL || used == NULL || digits == NULL) {
+        free(buckets);
+        free(used);
+        free(digits);
+        return -1;
+    }
+
+    for (i = 0; i < count; ++i) {
+        scalar_signed_digits(digits + i * windows, scalars[i], width, windows);
+    }
+
+    ge_p3_0(r);
+    for (w = windows; w-- > 0;) {
+        int have_running = 0;
+        int have_sum = 0;
+
+        if (started) {
+            ge_p3_dbl_n(r, width);
+        }
+
+        memset(used, 0, buckets_count);
+        for (i = 0; i < count; ++i) {
+            const int digit = digits[i * windows + w];
+            const size_t bucket = (size_t) (digit < 0 ? -digit : digit);
+
+            if (digit == 0) {
+                continue;
+            }
+            if (used[bucket]) {
+                if (digit > 0) {
+                    ge_add(&t, &buckets[bucket], &cached[i]);
+                } else {
+                    ge_sub(&t, &buckets[bucket], &cached[i]);
+                }
+                ge_p1p1_to_p3(&buckets[bucket], &t);
+            } else {
+                buckets[bucket] = points[i];
+                if (digit < 0) {
+                    fe_neg(buckets[bucket].X, buckets[bucket].X);
+                    fe_neg(buckets[bucket].T, buckets[bucket].T);
+                }
+                used[bucket] = 1;
+            }
+        }
+
+        /* sum(d * buckets[d]) as a sum of running sums */
+        for (d = buckets_count - 1; d > 0; --d) {
+            if (used[d]) {
+                if (have_running) {
+                    ge_p3_add_p3(&running, &running, &buckets[d]);
+                } else {
+                    running = buckets[d];
+                    have_running = 1;
+                }
+            }
+            if (have_running) {
+                if (have_sum) {
+                    ge_p3_add_p3(&window_sum, &window_sum, &running);
+                } else {
+                    window_sum = running;
+                    have_sum = 1;
+                }
+            }
+        }
+
+        if (have_sum) {
+            if (started) {
+                ge_p3_add_p3(r, r, &window_sum);
+            } else {
+                *r = window_sum;
+                started = 1;
+            }
+        }
+    }
+
+    free(buckets);
+    free(used);
+    free(digits);
+    return 0;
+}
+
+
+static void compute_hram(unsigned char *hram, const unsigned char *signature, const unsigned char *message, size_t message_len, const unsigned char *public_key) {
+    sha512_context hash;
+
+    sha512_init(&hash);
+    sha512_update(&hash, signature, 32);
+    sha512_update(&hash, public_key, 32);
+    sha512_update(&hash, message, message_len);
+    sha512_final(&hash, hram);
+    sc_reduce(hram);
+}
+
+/* Same checks as a batch of one, used when the batch buffers cannot be allocated */
+static int verify_single(const unsigned char *signature, const unsigned char *message, size_t message_len, const unsigned char *public_key,
+                         const ge_p3 *negated_public_key) {
+    unsigned char hram[64];
+    ge_p3 negated_R;
+
+    if (negated_public_key == NULL || (signature[63] & 224)) {
+        return 0;
+    }
+    if (!is_canonical_point(signature) || ge_frombytes_negate_vartime(&negated_R, signature) != 0) {
+        return 0;
+    }
+    compute_hram(hram, signature, message, message_len, public_key);
+    return verify_cofactored(signature, hram, negated_public_key, &negated_R);
+}
+
+int ed25519_verify_batch_decompressed(const unsigned char *const *signatures, const unsigned char *const *messages, const size_t *message_lens,
+                                      const unsigned char *const *public_keys, const ge_p3 *const *negated_public_keys, size_t count, int *valid) {
+    static const unsigned char zero[32] = {0};
+    unsigned char (*hram)[64];
+    unsigned char (*scalars)[32];
+    ge_p3 *points;
+    ge_cached *cached;
+    sha512_context hash;
+    unsigned char seed[64];
+    unsigned char base_scalar[32];
+    ge_p3 sum;
+    ge_p3 base;
+    size_t candidates = 0;
+    size_t i;
+    size_t k;
+    int batch_valid = 0;
+    int all_valid = 1;
+
+    if (count == 0) {
+        return 1;
+    }
+
+    hram = (unsigned char (*)[64]) malloc(count * sizeof(*hram));
+    scalars = (unsigned char (*)[32]) malloc(2 * count * sizeof(*scalars));
+    points = (ge_p3 *) malloc(2 * count * sizeof(ge_p3));
+    cached = (ge_cached *) malloc(2 * count * sizeof(ge_cached));
+
+    if (hram == NULL || scalars == NULL || points == NULL || cached == NULL) {
+        free(hram);
+        free(scalars);
+        free(points);
+        free(cached);
+
+        for (i = 0; i < count; ++i) {
+            valid[i] = verify_single(signatures[i], messages[i], message_lens[i], public_keys[i], negated_public_keys[i]);
+            all_valid &= valid[i];
+        }
+        return all_valid;
+    }
+
+    /* Same checks and challenge as ed25519_verify, everything hashed into the transcript the batch coefficients come from */
+    sha512_init(&hash);
+    for (i = 0; i < count; ++i) {
+        valid[i] = 0;
+        if (negated_public_keys[i] == NULL || (signatures[i][63] & 224)) {
+            continue;
+        }
+        if (!is_canonical_point(signatures[i]) || ge_frombytes_negate_vartime(&points[2 * candidates], signatures[i]) != 0) {
+            continue;
+        }
+
+        compute_hram(hram[i], signatures[i], messages[i], message_lens[i], public_keys[i]);
+
+        points[2 * candidates + 1] = *negated_public_keys[i];
+        sha512_update(&hash, signatures[i], 64);
+        sha512_update(&hash, public_keys[i], 32);
+        sha512_update(&hash, hram[i], 32);
+        valid[i] = 1;
+        ++candidates;
+    }
+    sha512_final(&hash, seed);
+
+    /*
+        With random 128-bit z_i, 8 * sum(z_i * (s_i * B - R_i - h_i * A_i)) = 0 holds for invalid signatures
+        with negligible probability. The z_i are derived from the transcript so they cannot be chosen by the caller.
+    */
+    if (candidates >= BATCH_MIN_SIZE) {
+        memset(base_scalar, 0, 32);
+        for (i = 0, k = 0; i < count; ++i) {
+            unsigned char z[64];
+            unsigned char index[8];
+            size_t j;
+
+            if (!valid[i]) {
+                continue;
+            }
+            for (j = 0; j < 8; ++j) {
+                index[j] = (unsigned char) (k >> (8 * j));
+            }
+            sha512_init(&hash);
+            sha512_update(&hash, seed, 64);
+            sha512_update(&hash, index, 8);
+            sha512_final(&hash, z);
+            memset(z + 16, 0, 16);
+            z[0] |= 1;
+
+            memcpy(scalars[2 * k], z, 32);
+            sc_muladd(scalars[2 * k + 1], z, hram[i], zero);
+            sc_muladd(base_scalar, z, signatures[i] + 32, base_scalar);
+            ++k;
+        }
+
+        for (k = 0; k < 2 * candidates; ++k) {
+            ge_p3_to_cached(&cached[k], &points[k]);
+        }
+
+        if (multiscalar_mul(&sum, points, cached, (const unsigned char (*)[32]) scalars, 2 * candidates) == 0) {
+            ge_scalarmult_base(&base, base_scalar);
+            ge_p3_add_p3(&sum, &sum, &base);
+            ge_p3_dbl_n(&sum, 3);
+            batch_valid = ge_p3_is_identity(&sum);
+        }
+    }
+
+    for (i = 0, k = 0; i < count; ++i) {
+        if (valid[i] && !batch_valid) {
+            valid[i] = verify_cofactored(signatures[i], hram[i], negated_public_keys[i], &points[2 * k]);
+            ++k;
+        }
+        all_valid &= valid[i];
+    }
+
+    free(hram);
+    free(scalars);
+    free(points);
+    free(cached);
+    return all_valid;
+}
+
+
+int ed25519_verify_batch(const unsigned char *const *signatures, const unsigned char *const *messages, const size_t *message_lens,
+                         const unsigned char *const *public_keys, size_t count, int *valid) {
+    ge_p3 *points;
+    const ge_p3 **negated_public_keys;
+    size_t i;
+    int all_valid = 1;
+
+    if (count == 0) {
+        return 1;
+    }
+
+    points = (ge_p3 *) malloc(count * sizeof(ge_p3));
+    negated_public_keys = (const ge_p3 **) malloc(count * sizeof(const ge_p3 *));
+    if (points == NULL || negated_public_keys == NULL) {
+        free(points);
+        free((void *) negated_public_keys);
+
+        for (i = 0; i < count; ++i) {
+            ge_p3 negated_public_key;
+            const int decoded = (ge_frombytes_negate_vartime(&negated_public_key, public_keys[i]) == 0);
+
+            valid[i] = verify_single(signatures[i], messages[i], message_lens[i], public_keys[i], decoded ? &negated_public_key : NULL);
+            all_valid &= valid[i];
+        }
+        return all_valid;
+    }
+
+    for (i = 0; i < count; ++i) {
+        negated_public_keys[i] = (ge_frombytes_negate_vartime(&points[i], public_keys[i]) == 0) ? &points[i] : NULL;
+    }
+
+    all_valid = ed25519_verify_batch_decompressed(signatures, messages, message_lens, public_keys, negated_public_keys, count, valid);
+    free(points);
+    free((void *) negated_public_keys);
+    return all_valid;
+}
@@ -0,0 +1,35 @@
+#!/usr/bin/env python3
+"""Generates include/ed25519/precomp_data_51.h from precomp_data.h.
+
+precomp_data.h stores field elements as 10 signed limbs of alternating 26 and 25 bits,
+the radix-2^51 backend (fe51.c) needs the same elements as 5 unsigned 51-bit limbs.
+
+usage: python3 tools/precomp_data_51.py > include/ed25519/precomp_data_51.h
+"""
+
+import os
+import re
+import sys
+
+P = 2**255 - 19
+REF10_LIMB_OFFSETS = [0, 26, 51, 77, 102, 128, 153, 179, 204, 230]
+FE10 = re.compile(r"\{\s*(-?\d+(?:\s*,\s*-?\d+){9})\s*\}")
+
+
+def to_fe51(match):
+    limbs = [int(limb) for limb in match.group(1).split(",")]
+    value = sum(limb << offset for limb, offset in zip(limbs, REF10_LIMB_OFFSETS)) % P
+    fe51 = [(value >> (51 * i)) & (2**51 - 1) for i in range(5)]
+    return "{ " + ", ".join(str(limb) for limb in fe51) + " }"
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    with open(os.path.join(here, "..", "include", "ed25519", "precomp_data.h")) as source:
+        table = source.read()
+    sys.stdout.write("/* Generated by tools/precomp_data_51.py from precomp_data.h, do not edit */\n\n")
+    sys.stdout.write(FE10.sub(to_fe51, table))
+
+
+if __name__ == "__main__":
+    main()
@@ -2,12 +2,26 @@
 #define SHA256_H
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace sha256
 {
     using hash_container = std::array<uint8_t, 32>;
 
+    // Implementation of the compression function, picked at runtime from what the CPU supports
+    enum class Backend {
+        Scalar, // portable reference implementation
+        ShaNi,  // x86 SHA extensions
+    };
+
+    // How hash_many processes several independent messages
+    enum class MultiBufferBackend {
+        Sequential, // one message after the other with the active Backend
+        Avx2,       // 8 messages at once, one per 32-bit lane of the AVX2 registers
+    };
+
     class SHA256 {
     public:
         SHA256();
@@ -17,40 +31,30 @@ namespace sha256
 
         static std::string to_string(const hash_container& digest);
 
+        // One-shot hash of a message
+        static hash_container hash(const uint8_t* data, size_t length);
+        // Hashes `count` independent messages into `digests`
+        static void hash_many(const uint8_t* const* messages, const size_t* lengths, size_t count, hash_container* digests);
+
+        [[nodiscard]] static bool is_supported(Backend backend);
+        [[nodiscard]] static bool is_supported(MultiBufferBackend backend);
+        [[nodiscard]] static Backend backend();
+        [[nodiscard]] static MultiBufferBackend multi_buffer_backend();
+        // Overrides the runtime selection, meant for benchmarks and for checking against the scalar reference.
+        // Must not be called while other threads are hashing, throws std::invalid_argument if the CPU lacks the backend.
+        static void set_backend(Backend backend);
+        static void set_multi_buffer_backend(MultiBufferBackend backend);
+
     private:
         std::array<uint8_t, 64> m_data;
         uint32_t m_blocklen;
         uint64_t m_bitlen;
         std::array <uint32_t, 8> m_state;
 
-        static constexpr std::array<uint32_t, 64> K = {
-            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
-            0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-            0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
-            0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
-            0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-            0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
-            0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
-            0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-            0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-        };
-
-        static uint32_t rotr(uint32_t x, uint32_t n);
-        static uint32_t choose(uint32_t e, uint32_t f, uint32_t g);
-        static uint32_t majority(uint32_t a, uint32_t b, uint32_t c);
-        static uint32_t sig0(uint32_t x);
-        static uint32_t sig1(uint32_t x);
         void transform();
         void pad();
         void revert(hash_container& hash) const;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -1,29 +1,155 @@
 #include <sha256/sha256.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iomanip>
 #include <sstream>
+#include <stdexcept>
+
+#include "sha256_backends.hpp"
 
 namespace sha256
 {
+    namespace
+    {
+        uint32_t rotr(uint32_t x, uint32_t n)
+        {
+            return (x >> n) | (x << (32 - n));
+        }
+
+        uint32_t choose(uint32_t e, uint32_t f, uint32_t g)
+        {
+            return (e & f) ^ (~e & g);
+        }
+
+        uint32_t majority(uint32_t a, uint32_t b, uint32_t c)
+        {
+            return (a & (b | c)) | (b & c);
+        }
+
+        uint32_t sig0(uint32_t x)
+        {
+            return rotr(x, 7) ^ rotr(x, 18) ^ (x >> 3);
+        }
+
+        uint32_t sig1(uint32_t x)
+        {
+            return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10);
+        }
+
+        detail::CompressFunction compress_function(Backend backend)
+        {
+            return (backend == Backend::ShaNi) ? detail::compress_sha_ni : detail::compress_scalar;
+        }
+
+        Backend detect_backend()
+        {
+            return detail::cpu_has_sha_ni() ? Backend::ShaNi : Backend::Scalar;
+        }
+
+        MultiBufferBackend detect_multi_buffer_backend()
+        {
+            // A single SHA-NI stream outruns eight AVX2 lanes, so lanes only pay off without the SHA extensions
+            return (!detail::cpu_has_sha_ni() && detail::cpu_has_avx2()) ? MultiBufferBackend::Avx2 : MultiBufferBackend::Sequential;
+        }
+
+        struct Dispatch {
+            std::atomic<Backend> backend = detect_backend();
+            std::atomic<detail::CompressFunction> compress = compress_function(backend.load());
+            std::atomic<MultiBufferBackend> multi_buffer_backend = detect_multi_buffer_backend();
+        };
+
+        // Function-local so hashing from other static initializers still finds a selected backend
+        Dispatch& dispatch()
+        {
+            static Dispatch instance;
+            return instance;
+        }
+    }
+
+    namespace detail
+    {
+        void compress_scalar(uint32_t* state, const uint8_t* blocks, size_t block_count)
+        {
+            for (; block_count > 0; block_count--, blocks += 64) {
+                uint32_t maj, xorA, ch, xorE, sum, newA, newE, m[64];
+                uint32_t working_state[8];
+
+                for (uint8_t i = 0, j = 0; i < 16; i++, j += 4) { // Split data in 32 bit blocks for the 16 first words
+                    m[i] = (blocks[j] << 24) | (blocks[j + 1] << 16) | (blocks[j + 2] << 8) | (blocks[j + 3]);
+                }
+
+                for (uint8_t k = 16; k < 64; k++) { // Remaining 48 blocks
+                    m[k] = sig1(m[k - 2]) + m[k - 7] + sig0(m[k - 15]) + m[k - 16];
+                }
+
+                for (uint8_t i = 0; i < 8; i++) {
+                    working_state[i] = state[i];
+                }
+
+                for (uint8_t i = 0; i < 64; i++) {
+                    maj = majority(working_state[0], working_state[1], working_state[2]);
+                    xorA = rotr(working_state[0], 2) ^ rotr(working_state[0], 13) ^ rotr(working_state[0], 22);
+
+                    ch = choose(working_state[4], working_state[5], working_state[6]);
+
+                    xorE = rotr(working_state[4], 6) ^ rotr(working_state[4], 11) ^ rotr(working_state[4], 25);
+
+                    sum = m[i] + K[i] + working_state[7] + ch + xorE;
+                    newA = xorA + maj + sum;
+                    newE = working_state[3] + sum;
+
+                    working_state[7] = working_state[6];
+                    working_state[6] = working_state[5];
+                    working_state[5] = working_state[4];
+                    working_state[4] = newE;
+                    working_state[3] = working_state[2];
+                    working_state[2] = working_state[1];
+                    working_state[1] = working_state[0];
+                    working_state[0] = newA;
+                }
+
+                for (uint8_t i = 0; i < 8; i++) {
+                    state[i] += working_state[i];
+                }
+            }
+        }
+
+        void padded_block(const uint8_t* message, size_t length, size_t block_index, uint8_t* block)
+        {
+            const size_t offset = block_index * 64;
+            std::memset(block, 0, 64);
+            if (offset < length) {
+                std::memcpy(block, message + offset, std::min<size_t>(64, length - offset));
+            }
+            if (length >= offset && length - offset < 64) {
+                block[length - offset] = 0x80; // Append a bit 1
+            }
+            if (block_index + 1 == padded_block_count(length)) {
+                const uint64_t bitlen = static_cast<uint64_t>(length) * 8;
+                for (uint8_t i = 0; i < 8; i++) {
+                    block[63 - i] = static_cast<uint8_t>(bitlen >> (i * 8));
+                }
+            }
+        }
+    }
+
     SHA256::SHA256()
         : m_blocklen(0)
         , m_bitlen(0)
+        , m_state(detail::INITIAL_STATE)
     {
-        m_state[0] = 0x6a09e667;
-        m_state[1] = 0xbb67ae85;
-        m_state[2] = 0x3c6ef372;
-        m_state[3] = 0xa54ff53a;
-        m_state[4] = 0x510e527f;
-        m_state[5] = 0x9b05688c;
-        m_state[6] = 0x1f83d9ab;
-        m_state[7] = 0x5be0cd19;
     }
 
     void SHA256::update(const uint8_t* data, size_t length)
     {
-        for (size_t i = 0; i < length; i++) {
-            m_data[m_blocklen++] = data[i];
+        if (m_blocklen > 0) {
+            const size_t fill = std::min<size_t>(64 - m_blocklen, length);
+            std::memcpy(m_data.data() + m_blocklen, data, fill);
+            m_blocklen += static_cast<uint32_t>(fill);
+            data += fill;
+            length -= fill;
             if (m_blocklen == 64) {
                 transform();
 
@@ -32,6 +158,20 @@ namespace sha256
                 m_blocklen = 0;
             }
         }
+
+        // Whole blocks are compressed straight from the input
+        const size_t block_count = length / 64;
+        if (block_count > 0) {
+            dispatch().compress.load(std::memory_order_relaxed)(m_state.data(), data, block_count);
+            m_bitlen += 512 * static_cast<uint64_t>(block_count);
+            data += block_count * 64;
+            length -= block_count * 64;
+        }
+
+        if (length > 0) {
+            std::memcpy(m_data.data(), data, length);
+            m_blocklen = static_cast<uint32_t>(length);
+        }
     }
 
     void SHA256::update(const std::string& data)
@@ -49,73 +189,64 @@ namespace sha256
         return hash;
     }
 
-    uint32_t SHA256::rotr(uint32_t x, uint32_t n)
+    hash_container SHA256::hash(const uint8_t* data, size_t length)
     {
-        return (x >> n) | (x << (32 - n));
+        SHA256 hasher;
+        hasher.update(data, length);
+        return hasher.digest();
     }
 
-    uint32_t SHA256::choose(uint32_t e, uint32_t f, uint32_t g)
+    void SHA256::hash_many(const uint8_t* const* messages, const size_t* lengths, size_t count, hash_container* digests)
     {
-        return (e & f) ^ (~e & g);
+        if (dispatch().multi_buffer_backend.load(std::memory_order_relaxed) == MultiBufferBackend::Avx2) {
+            detail::hash_many_avx2(messages, lengths, count, digests);
+            return;
+        }
+        for (size_t i = 0; i < count; i++) {
+            digests[i] = hash(messages[i], lengths[i]);
+        }
     }
 
-    uint32_t SHA256::majority(uint32_t a, uint32_t b, uint32_t c)
+    bool SHA256::is_supported(Backend backend)
     {
-        return (a & (b | c)) | (b & c);
+        return backend == Backend::Scalar || (backend == Backend::ShaNi && detail::cpu_has_sha_ni());
     }
 
-    uint32_t SHA256::sig0(uint32_t x)
+    bool SHA256::is_supported(MultiBufferBackend backend)
     {
-        return SHA256::rotr(x, 7) ^ SHA256::rotr(x, 18) ^ (x >> 3);
+        return backend == MultiBufferBackend::Sequential || (backend == MultiBufferBackend::Avx2 && detail::cpu_has_avx2());
     }
 
-    uint32_t SHA256::sig1(uint32_t x)
+    Backend SHA256::backend()
     {
-        return SHA256::rotr(x, 17) ^ SHA256::rotr(x, 19) ^ (x >> 10);
+        return dispatch().backend.load();
     }
 
-    void SHA256::transform()
+    MultiBufferBackend SHA256::multi_buffer_backend()
     {
-        uint32_t maj, xorA, ch, xorE, sum, newA, newE, m[64];
-        uint32_t state[8];
-
-        for (uint8_t i = 0, j = 0; i < 16; i++, j += 4) { // Split data in 32 bit blocks for the 16 first words
-            m[i] = (m_data[j] << 24) | (m_data[j + 1] << 16) | (m_data[j + 2] << 8) | (m_data[j + 3]);
-        }
-
-        for (uint8_t k = 16; k < 64; k++) { // Remaining 48 blocks
-            m[k] = SHA256::sig1(m[k - 2]) + m[k - 7] + SHA256::sig0(m[k - 15]) + m[k - 16];
-        }
+        return dispatch().multi_buffer_backend.load();
+    }
 
-        for (uint8_t i = 0; i < 8; i++) {
-            state[i] = m_state[i];
+    void SHA256::set_backend(Backend backend)
+    {
+        if (!is_supported(backend)) {
+            throw std::invalid_argument("SHA-256 backend is not supported by this CPU");
         }
+        dispatch().backend = backend;
+        dispatch().compress = compress_function(backend);
+    }
 
-        for (uint8_t i = 0; i < 64; i++) {
-            maj = SHA256::majority(state[0], state[1], state[2]);
-            xorA = SHA256::rotr(state[0], 2) ^ SHA256::rotr(state[0], 13) ^ SHA256::rotr(state[0], 22);
-
-            ch = choose(state[4], state[5], state[6]);
-
-            xorE = SHA256::rotr(state[4], 6) ^ SHA256::rotr(state[4], 11) ^ SHA256::rotr(state[4], 25);
-
-            sum = m[i] + K[i] + state[7] + ch + xorE;
-            newA = xorA + maj + sum;
-            newE = state[3] + sum;
-
-            state[7] = state[6];
-            state[6] = state[5];
-            state[5] = state[4];
-            state[4] = newE;
-            state[3] = state[2];
-            state[2] = state[1];
-            state[1] = state[0];
-            state[0] = newA;
+    void SHA256::set_multi_buffer_backend(MultiBufferBackend backend)
+    {
+        if (!is_supported(backend)) {
+            throw std::invalid_argument("SHA-256 multi-buffer backend is not supported by this CPU");
         }
+        dispatch().multi_buffer_backend = backend;
+    }
 
-        for (uint8_t i = 0; i < 8; i++) {
-            m_state[i] += state[i];
-        }
+    void SHA256::transform()
+    {
+        dispatch().compress.load(std::memory_order_relaxed)(m_state.data(), m_data.data(), 1);
     }
 
     void SHA256::pad()
@@ -169,4 +300,4 @@ namespace sha256
 
         return s.str();
     }
-}
\ No newline at end of file
+}
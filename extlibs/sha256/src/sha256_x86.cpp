@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "sha256_backends.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SHA256_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// GCC and Clang only emit SHA/AVX2 instructions in functions that opt in, MSVC always allows the intrinsics
+#if defined(SHA256_X86) && !defined(_MSC_VER)
+#define SHA256_TARGET(features) __attribute__((target(features)))
+#else
+#define SHA256_TARGET(features)
+#endif
+
+namespace sha256::detail
+{
+#ifdef SHA256_X86
+    namespace
+    {
+        struct CpuFeatures {
+            bool sha_ni = false;
+            bool avx2 = false;
+        };
+
+        void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t registers[4])
+        {
+#if defined(_MSC_VER)
+            int values[4];
+            __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+            for (int i = 0; i < 4; i++) {
+                registers[i] = static_cast<uint32_t>(values[i]);
+            }
+#else
+            __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+        }
+
+        SHA256_TARGET("xsave")
+        uint64_t enabled_register_state()
+        {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            return __builtin_ia32_xgetbv(0);
+#endif
+        }
+
+        CpuFeatures detect_features()
+        {
+            CpuFeatures features;
+            uint32_t registers[4] = {};
+            cpuid(0, 0, registers);
+            const uint32_t max_leaf = registers[0];
+            if (max_leaf < 7) {
+                return features;
+            }
+
+            cpuid(1, 0, registers);
+            const bool sse41 = (registers[2] & (1u << 19)) != 0;
+            const bool ssse3 = (registers[2] & (1u << 9)) != 0;
+            const bool osxsave = (registers[2] & (1u << 27)) != 0;
+            // AVX2 also needs the OS to save the upper halves of the YMM registers on context switches
+            const bool ymm_enabled = osxsave && (enabled_register_state() & 0x6) == 0x6;
+
+            cpuid(7, 0, registers);
+            features.sha_ni = sse41 && ssse3 && (registers[1] & (1u << 29)) != 0;
+            features.avx2 = ymm_enabled && (registers[1] & (1u << 5)) != 0;
+            return features;
+        }
+
+        const CpuFeatures& cpu_features()
+        {
+            static const CpuFeatures features = detect_features();
+            return features;
+        }
+    }
+
+    bool cpu_has_sha_ni()
+    {
+        return cpu_features().sha_ni;
+    }
+
+    bool cpu_has_avx2()
+    {
+        return cpu_features().avx2;
+    }
+
+    SHA256_TARGET("sha,sse4.1,ssse3")
+    void compress_sha_ni(uint32_t* state, const uint8_t* blocks, size_t block_count)
+    {
+        const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+        // The SHA instructions keep the state as ABEF / CDGH
+        __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+        __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4));
+        tmp = _mm_shuffle_epi32(tmp, 0xB1);
+        state1 = _mm_shuffle_epi32(state1, 0x1B);
+        __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+        state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+        for (; block_count > 0; block_count--, blocks += 64) {
+            const __m128i abef_save = state0;
+            const __m128i cdgh_save = state1;
+            __m128i words[4];
+
+            // Each step does 4 rounds, and from the fifth step on also extends the message schedule by 4 words
+            for (int step = 0; step < 16; step++) {
+                __m128i& current = words[step % 4];
+                if (step < 4) {
+                    current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + step * 16)), byte_swap);
+                } else {
+                    const __m128i& previous = words[(step + 3) % 4];
+                    const __m128i extended = _mm_add_epi32(_mm_sha256msg1_epu32(current, words[(step + 1) % 4]),
+                        _mm_alignr_epi8(previous, words[(step + 2) % 4], 4));
+                    current = _mm_sha256msg2_epu32(extended, previous);
+                }
+
+                __m128i message = _mm_add_epi32(current, _mm_loadu_si128(reinterpret_cast<const __m128i*>(K.data() + step * 4)));
+                state1 = _mm_sha256rnds2_epu32(state1, state0, message);
+                message = _mm_shuffle_epi32(message, 0x0E);
+                state0 = _mm_sha256rnds2_epu32(state0, state1, message);
+            }
+
+            state0 = _mm_add_epi32(state0, abef_save);
+            state1 = _mm_add_epi32(state1, cdgh_save);
+        }
+
+        tmp = _mm_shuffle_epi32(state0, 0x1B);
+        state1 = _mm_shuffle_epi32(state1, 0xB1);
+        state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+        state1 = _mm_alignr_epi8(state1, tmp, 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+    }
+
+    namespace
+    {
+        constexpr size_t LANES = 8;
+
+        SHA256_TARGET("avx2")
+        inline __m256i rotr(__m256i x, int n)
+        {
+            return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+        }
+
+        // Compresses one block per lane, `words` holds the 16 big endian message words transposed across lanes
+        SHA256_TARGET("avx2")
+        void compress_lanes(__m256i state[8], __m256i words[16])
+        {
+            __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+            __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+            for (int i = 0; i < 64; i++) {
+                __m256i& w = words[i % 16];
+                if (i >= 16) {
+                    const __m256i w15 = words[(i + 1) % 16];
+                    const __m256i w2 = words[(i + 14) % 16];
+                    const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr(w15, 7), rotr(w15, 18)), _mm256_srli_epi32(w15, 3));
+                    const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr(w2, 17), rotr(w2, 19)), _mm256_srli_epi32(w2, 10));
+                    w = _mm256_add_epi32(_mm256_add_epi32(w, s0), _mm256_add_epi32(words[(i + 9) % 16], s1));
+                }
+
+                const __m256i sum_e = _mm256_xor_si256(_mm256_xor_si256(rotr(e, 6), rotr(e, 11)), rotr(e, 25));
+                const __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+                const __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, sum_e), _mm256_add_epi32(ch, w)),
+                    _mm256_set1_epi32(static_cast<int>(K[i])));
+                const __m256i sum_a = _mm256_xor_si256(_mm256_xor_si256(rotr(a, 2), rotr(a, 13)), rotr(a, 22));
+                const __m256i maj = _mm256_or_si256(_mm256_and_si256(a, _mm256_or_si256(b, c)), _mm256_and_si256(b, c));
+                const __m256i t2 = _mm256_add_epi32(sum_a, maj);
+
+                h = g;
+                g = f;
+                f = e;
+                e = _mm256_add_epi32(d, t1);
+                d = c;
+                c = b;
+                b = a;
+                a = _mm256_add_epi32(t1, t2);
+            }
+
+            state[0] = _mm256_add_epi32(state[0], a);
+            state[1] = _mm256_add_epi32(state[1], b);
+            state[2] = _mm256_add_epi32(state[2], c);
+            state[3] = _mm256_add_epi32(state[3], d);
+            state[4] = _mm256_add_epi32(state[4], e);
+            state[5] = _mm256_add_epi32(state[5], f);
+            state[6] = _mm256_add_epi32(state[6], g);
+            state[7] = _mm256_add_epi32(state[7], h);
+        }
+
+        inline uint32_t load_big_endian(const uint8_t* bytes)
+        {
+            return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) | (static_cast<uint32_t>(bytes[2]) << 8) | bytes[3];
+        }
+    }
+
+    SHA256_TARGET("avx2")
+    void hash_many_avx2(const uint8_t* const* messages, const size_t* lengths, size_t count, hash_container* digests)
+    {
+        for (size_t first = 0; first < count; first += LANES) {
+            const size_t lanes = std::min(LANES, count - first);
+
+            alignas(32) int32_t lane_block_counts[LANES] = {};
+            size_t max_block_count = 0;
+            for (size_t lane = 0; lane < lanes; lane++) {
+                const size_t block_count = padded_block_count(lengths[first + lane]);
+                lane_block_counts[lane] = static_cast<int32_t>(block_count);
+                max_block_count = std::max(max_block_count, block_count);
+            }
+            const __m256i block_counts = _mm256_load_si256(reinterpret_cast<const __m256i*>(lane_block_counts));
+
+            __m256i state[8];
+            for (int i = 0; i < 8; i++) {
+                state[i] = _mm256_set1_epi32(static_cast<int>(INITIAL_STATE[i]));
+            }
+
+            alignas(32) uint8_t lane_blocks[LANES][64] = {};
+            alignas(32) uint32_t lane_words[16][LANES];
+            for (size_t block_index = 0; block_index < max_block_count; block_index++) {
+                for (size_t lane = 0; lane < lanes; lane++) {
+                    if (block_index < static_cast<size_t>(lane_block_counts[lane])) {
+                        padded_block(messages[first + lane], lengths[first + lane], block_index, lane_blocks[lane]);
+                    }
+                }
+                for (size_t word = 0; word < 16; word++) {
+                    for (size_t lane = 0; lane < LANES; lane++) {
+                        lane_words[word][lane] = load_big_endian(lane_blocks[lane] + word * 4);
+                    }
+                }
+                __m256i words[16];
+                for (size_t word = 0; word < 16; word++) {
+                    words[word] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lane_words[word]));
+                }
+
+                __m256i next_state[8] = { state[0], state[1], state[2], state[3], state[4], state[5], state[6], state[7] };
+                compress_lanes(next_state, words);
+
+                // Lanes whose message has no block left keep their final state
+                const __m256i active = _mm256_cmpgt_epi32(block_counts, _mm256_set1_epi32(static_cast<int>(block_index)));
+                for (int i = 0; i < 8; i++) {
+                    state[i] = _mm256_blendv_epi8(state[i], next_state[i], active);
+                }
+            }
+
+            alignas(32) uint32_t lane_state[8][LANES];
+            for (int i = 0; i < 8; i++) {
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lane_state[i]), state[i]);
+            }
+            for (size_t lane = 0; lane < lanes; lane++) {
+                hash_container& digest = digests[first + lane];
+                for (int i = 0; i < 8; i++) {
+                    const uint32_t value = lane_state[i][lane];
+                    digest[i * 4] = static_cast<uint8_t>(value >> 24);
+                    digest[i * 4 + 1] = static_cast<uint8_t>(value >> 16);
+                    digest[i * 4 + 2] = static_cast<uint8_t>(value >> 8);
+                    digest[i * 4 + 3] = static_cast<uint8_t>(value);
+                }
+            }
+        }
+    }
+#else
+    bool cpu_has_sha_ni()
+    {
+        return false;
+    }
+
+    bool cpu_has_avx2()
+    {
+        return false;
+    }
+
+    void compress_sha_ni(uint32_t*, const uint8_t*, size_t)
+    {
+        std::abort();
+    }
+
+    void hash_many_avx2(const uint8_t* const*, const size_t*, size_t, hash_container*)
+    {
+        std::abort();
+    }
+#endif
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace ntb
+{
+    // Access key details as returned by a view_access_key query
+    struct CachedAccessKey
+    {
+        std::string permission;
+        uint64_t nonce;
+        std::string block_hash;
+        uint64_t block_height;
+    };
+
+    // JSON file keeping access key details between runs, so a client can sign before hearing back from the network.
+    // Entries are only hints: a stale nonce, block hash or deleted key is reloaded from the network once a transaction signed with it fails
+    class AccessKeyCache
+    {
+    private:
+        std::string m_path;
+
+    public:
+        explicit AccessKeyCache(std::string path);
+
+        // Keyed by base58 public key, a missing or unreadable file counts as empty
+        [[nodiscard]] std::map<std::string, CachedAccessKey> load(const std::string &network, const std::string &account_id) const;
+        // Merges `access_keys` into the file, returns false if it could not be written
+        bool store(const std::string &network, const std::string &account_id, const std::map<std::string, CachedAccessKey> &access_keys) const;
+
+        [[nodiscard]] const std::string &path() const;
+    };
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include <ntb/rpc.hpp>
+
+namespace ntb
+{
+    struct BlockHashRefresherOptions
+    {
+        // Transactions stay valid for about a day of blocks, refreshing every minute keeps them far from expiring
+        std::chrono::milliseconds interval = std::chrono::minutes(1);
+        // Wait before trying again after a failed refresh
+        std::chrono::milliseconds retry_interval = std::chrono::seconds(1);
+    };
+
+    // Keeps a recent final block hash for transactions, fetched with the "block" RPC method on a background thread
+    class BlockHashRefresher
+    {
+    private:
+        RPCClient &m_rpc;
+        BlockHashRefresherOptions m_options;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wakeup;
+        std::array<uint8_t, 32> m_block_hash = {};
+        uint64_t m_block_height = 0;
+        bool m_has_block_hash = false;
+        // Incremented by every refresh, lets concurrent refresh_now calls share one fetch
+        uint64_t m_generation = 0;
+        std::chrono::steady_clock::time_point m_next_refresh;
+        bool m_refresh_requested = false;
+        bool m_stopping = false;
+        // Serializes fetches, never held together with m_mutex while waiting on the network
+        std::mutex m_refresh_mutex;
+        std::thread m_thread;
+
+        void _run();
+        void _fetch();
+
+    public:
+        explicit BlockHashRefresher(RPCClient &rpc, const BlockHashRefresherOptions &options = {});
+        BlockHashRefresher(const BlockHashRefresher &) = delete;
+        BlockHashRefresher &operator=(const BlockHashRefresher &) = delete;
+        ~BlockHashRefresher();
+
+        // Returns the latest known hash without waiting, only the very first call fetches one if none was seeded
+        [[nodiscard]] std::array<uint8_t, 32> block_hash();
+        // Hash known from another response, such as an access key query, kept only if it is newer
+        void seed(const std::array<uint8_t, 32> &block_hash, uint64_t block_height);
+        // Fetches a new hash before returning, callers racing each other share a single fetch. Throws on RPC errors
+        void refresh_now();
+        // Wakes up the background thread to refresh without waiting for it
+        void request_refresh();
+
+        [[nodiscard]] uint64_t block_height() const;
+    };
+}
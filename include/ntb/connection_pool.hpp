@@ -0,0 +1,66 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <httplib/httplib.h>
+
+namespace ntb
+{
+    struct ConnectionPoolOptions
+    {
+        std::size_t size = 4;
+        bool keep_alive = true;
+        time_t connection_timeout_sec = 5;
+        time_t read_timeout_sec = 60;
+    };
+
+    // Fixed set of persistent HTTP connections to one endpoint, checked out per request
+    class ConnectionPool
+    {
+    public:
+        class Lease
+        {
+        private:
+            ConnectionPool *m_pool;
+            httplib::Client *m_client;
+
+        public:
+            Lease(ConnectionPool &pool, httplib::Client &client);
+            Lease(Lease &&other) noexcept;
+            Lease(const Lease &) = delete;
+            Lease &operator=(const Lease &) = delete;
+            Lease &operator=(Lease &&) = delete;
+            ~Lease();
+
+            httplib::Client &operator*() const;
+            httplib::Client *operator->() const;
+        };
+
+    private:
+        std::string m_endpoint;
+        std::vector<std::unique_ptr<httplib::Client>> m_connections;
+        std::vector<httplib::Client *> m_idle;
+        std::mutex m_mutex;
+        std::condition_variable m_available;
+
+        void _release(httplib::Client *client);
+
+    public:
+        ConnectionPool(const std::string &endpoint, const ConnectionPoolOptions &options = {});
+        ConnectionPool(const ConnectionPool &) = delete;
+        ConnectionPool &operator=(const ConnectionPool &) = delete;
+
+        // Blocks until a connection is idle
+        Lease acquire();
+        // Empty if every connection is in use
+        std::optional<Lease> try_acquire();
+
+        [[nodiscard]] const std::string &endpoint() const;
+        [[nodiscard]] std::size_t size() const;
+    };
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <borsh/borsh.hpp>
+
+namespace ntb
+{
+    // Function call arguments already serialized by the caller (JSON text, Borsh...), sent to the contract as is.
+    // Only views the bytes, which must outlive the call
+    class RawArgs
+    {
+    private:
+        const uint8_t *m_data;
+        std::size_t m_size;
+
+    public:
+        constexpr RawArgs(const uint8_t *data, std::size_t size) : m_data(data), m_size(size) {}
+        // Templates so braced JSON initializers such as {{"key", "value"}} keep resolving to the nlohmann::json overloads
+        template <class Text, std::enable_if_t<std::is_convertible_v<const Text &, std::string_view>, int> = 0>
+        explicit RawArgs(const Text &text)
+        {
+            const std::string_view view = text;
+            m_data = reinterpret_cast<const uint8_t *>(view.data());
+            m_size = view.size();
+        }
+        template <class Bytes, std::enable_if_t<std::is_same_v<Bytes, std::vector<uint8_t>>, int> = 0>
+        explicit RawArgs(const Bytes &bytes) : m_data(bytes.data()), m_size(bytes.size()) {}
+
+        constexpr const uint8_t *data() const
+        {
+            return m_data;
+        }
+        constexpr std::size_t size() const
+        {
+            return m_size;
+        }
+    };
+
+    // Borsh encoded arguments for contracts taking binary input, `value` can be any type BorshEncoder supports
+    class BorshArgs
+    {
+    private:
+        std::vector<uint8_t> m_bytes;
+
+    public:
+        template <class T>
+        explicit BorshArgs(const T &value)
+        {
+            BorshEncoder(m_bytes).EncodeExact(value);
+        }
+
+        const std::vector<uint8_t> &bytes() const
+        {
+            return m_bytes;
+        }
+
+        operator RawArgs() const
+        {
+            return RawArgs(m_bytes);
+        }
+    };
+}
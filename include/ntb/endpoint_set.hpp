@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ntb/connection_pool.hpp>
+
+namespace ntb
+{
+    struct EndpointHealthOptions
+    {
+        // Weight of the newest sample in the latency and error rate moving averages
+        double smoothing = 0.2;
+        // Consecutive failures after which an endpoint is ejected
+        uint32_t failure_threshold = 3;
+        // How long an ejected endpoint is skipped before a single request probes it again
+        std::chrono::milliseconds ejection_time = std::chrono::seconds(10);
+    };
+
+    struct EndpointStats
+    {
+        std::string endpoint;
+        // Moving averages, the latency only counts successful requests
+        std::chrono::microseconds latency;
+        double error_rate;
+        uint64_t requests;
+        uint64_t failures;
+        bool ejected;
+    };
+
+    // RPC endpoints with their connection pools and health, picks the fastest healthy one for each request
+    class EndpointSet
+    {
+    private:
+        struct Endpoint
+        {
+            std::unique_ptr<ConnectionPool> pool;
+            double latency_us = 0;
+            double error_rate = 0;
+            uint64_t requests = 0;
+            uint64_t failures = 0;
+            uint32_t consecutive_failures = 0;
+            bool ejected = false;
+            bool probing = false;
+            std::chrono::steady_clock::time_point ejected_until;
+        };
+
+        EndpointHealthOptions m_options;
+        std::vector<Endpoint> m_endpoints;
+        mutable std::mutex m_mutex;
+
+    public:
+        EndpointSet(const std::vector<std::string> &endpoints, const ConnectionPoolOptions &connections, const EndpointHealthOptions &options = {});
+        EndpointSet(const EndpointSet &) = delete;
+        EndpointSet &operator=(const EndpointSet &) = delete;
+
+        // Index of the endpoint with the lowest expected latency among those not `tried` yet.
+        // Ejected endpoints are skipped unless their ejection time is over (one probe at a time) or nothing else is left
+        [[nodiscard]] std::size_t select(const std::vector<bool> &tried);
+        // Records the outcome of a request sent with select()
+        void report(std::size_t index, std::chrono::steady_clock::duration latency, bool success);
+        // For an endpoint returned by select() that ends up not being sent anything
+        void abandon(std::size_t index);
+
+        [[nodiscard]] ConnectionPool &pool(std::size_t index) const;
+        [[nodiscard]] std::size_t size() const;
+        // Connections across all endpoints
+        [[nodiscard]] std::size_t connections_count() const;
+        [[nodiscard]] std::vector<EndpointStats> stats() const;
+    };
+}
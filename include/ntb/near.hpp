@@ -2,14 +2,28 @@
 
 #include <array>
 #include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string_view>
+#include <type_traits>
+#include <vector>
 
-#include <bignumber/bignumber.hpp>
 #include <nlohmann/json.hpp>
 
+#include <ntb/access_key_cache.hpp>
+#include <ntb/block_hash_refresher.hpp>
+#include <ntb/contract_args.hpp>
+#include <ntb/near_amount.hpp>
+#include <ntb/nonce_manager.hpp>
 #include <ntb/rpc.hpp>
 #include <ntb/schemas.hpp>
 #include <ntb/signer.hpp>
+#include <ntb/transaction_builder.hpp>
+#include <ntb/transaction_template.hpp>
+#include <ntb/transaction_tracker.hpp>
 
 namespace ntb
 {
@@ -33,6 +47,12 @@ namespace ntb
 	{
 	};
 
+	struct SubmittedTransaction
+	{
+		std::string hash;
+		std::future<RPCResponse> outcome;
+	};
+
 	enum class AccessKeyPermission
 	{
 		None,
@@ -47,28 +67,6 @@ namespace ntb
 		std::string block_hash;
 	};
 
-	struct NearAmount
-	{
-	protected:
-		BigNumber m_amount;
-
-	public:
-		NearAmount(int amount);
-		NearAmount(long long amount);
-		NearAmount(double amount);
-		NearAmount(const std::string &amount);
-		NearAmount(const char *amount);
-
-		static NearAmount from_yocto(const std::string &amount)
-		{
-			NearAmount near_amount(0.0);
-			near_amount.m_amount = amount;
-			return near_amount;
-		}
-
-		operator BigNumber() const;
-	};
-
 	struct ImplicitAccount
 	{
 	};
@@ -85,41 +83,184 @@ namespace ntb
 
 	using AccountId = std::variant<ImplicitAccount, NamedAccount, AccountIdResolver>;
 
+	// When NearClient loads the nonce and permission of its access keys
+	enum class NearClientStartup
+	{
+		// In the constructor
+		Blocking,
+		// In the first call that needs them
+		Lazy,
+		// On a background thread started by the constructor, calls that need them wait for it
+		Background,
+	};
+
+	struct NearClientOptions
+	{
+		// Used instead of rpc.{network}.near.org when not empty
+		std::vector<std::string> rpc_endpoints;
+		RPCClientOptions rpc;
+		TransactionTrackerOptions tracker;
+		BlockHashRefresherOptions block_hash;
+		NearClientStartup startup = NearClientStartup::Blocking;
+		// AccessKeyCache file, access keys found there are not queried at startup. Empty disables it
+		std::string access_key_cache_path;
+	};
+
 	class NearClient
 	{
 	private:
+		// One access key of the account, transactions are scheduled on the least loaded one
+		struct KeySlot
+		{
+			std::unique_ptr<Signer> signer;
+			std::array<uint8_t, 32> public_key;
+			std::string public_key_b58;
+			std::shared_ptr<NonceManager> nonces;
+			mutable std::mutex access_key_mutex;
+			AccessKey access_key{};
+			// Set when a tracked transaction was rejected, the next send on this key reloads it first
+			std::atomic<bool> reload_requested = false;
+			// Not checked against the chain yet, the first rejected transaction reloads it
+			bool from_cache = false;
+		};
+
+		struct Broadcast
+		{
+			KeySlot *key;
+			uint64_t nonce;
+			std::array<uint8_t, 32> tx_hash;
+			nlohmann::json result;
+		};
+
 		std::string m_network;
 		ntb::RPCClient m_rpc;
 
 		std::string m_account_id;
-		std::unique_ptr<Signer> m_signer;
-		AccessKey m_access_key;
-		std::atomic<int> m_nonce_increment;
+		std::vector<std::unique_ptr<KeySlot>> m_keys;
+		mutable std::mutex m_keys_mutex;
+		ntb::BlockHashRefresher m_block_hashes;
+		std::optional<AccessKeyCache> m_access_key_cache;
+		std::mutex m_startup_mutex;
+		std::atomic<bool> m_started = false;
+		// After the keys so its polling thread stops before they are destroyed
+		ntb::TransactionTracker m_tracker;
+		// Last member so a background startup is done before the rest of the client is destroyed
+		std::shared_future<void> m_background_startup;
+
+		template <class SignerClass>
+		static std::vector<std::unique_ptr<Signer>> _make_signers(SignerClass &&signing_method);
 
 	protected:
 		static std::string _get_rpc_endpoint(const std::string &network);
-		void _load_access_key();
-		void _assert_access_key_sufficient_permissions(AccessKeyPermission minimum_permission);
+		// Loads the access keys once, from the cache file first. Throws if the network lookup fails
+		void _start();
+		void _load_access_keys(const std::vector<KeySlot *> &keys, const std::string &finality = "final");
+		void _apply_access_key(KeySlot &key, const CachedAccessKey &access_key, bool from_cache);
+		// Saves the nonces used so far, so the next run does not start from stale ones
+		void _store_access_keys(const std::vector<KeySlot *> &keys);
+		void _assert_access_key_sufficient_permissions(const KeySlot &key, AccessKeyPermission minimum_permission);
 		void _resolve_account_id(AccountId account_id);
+		KeySlot &_add_key(std::unique_ptr<Signer> signer);
+		// Slots are only scheduled once added, so their access key must be loaded before
+		std::unique_ptr<KeySlot> _make_key(std::unique_ptr<Signer> signer) const;
+		KeySlot &_add_key(std::unique_ptr<KeySlot> key);
+		KeySlot &_select_key();
+		// Never waits on the network once the access keys are loaded
+		std::array<uint8_t, 32> _recent_block_hash();
+		// Builds into the calling thread's TransactionBuilder, which stays valid until the thread builds another transaction
+		TransactionBuilder &_build_transaction(const KeySlot &key, const std::string &recipient, const std::vector<schemas::Action> &actions, uint64_t nonce);
+		// Leaves the nonce in flight on success, callers release it once they are done with the transaction
+		Broadcast _broadcast(const std::string &method_name, const std::function<TransactionBuilder &(const KeySlot &, uint64_t)> &build);
+		Broadcast _broadcast(const std::string &method_name, const std::string &recipient, const std::vector<schemas::Action> &actions);
+		// Reads the bytes returned by a view function straight out of the response body
+		std::vector<uint8_t> _view_function(const std::string &contract_address, const std::string &method_name, RawArgs args);
 
 	public:
-		template <class SignerClass>
-		explicit NearClient(const std::string_view network, SignerClass &&signing_method, const AccountId &account_id);
+		template <class SignerClass, std::enable_if_t<std::is_base_of_v<Signer, std::decay_t<SignerClass>>, int> = 0>
+		explicit NearClient(const std::string_view network, SignerClass &&signing_method, const AccountId &account_id, const NearClientOptions &options = {});
+		// Several access keys of the same account, the first one is used to resolve implicit account ids
+		explicit NearClient(const std::string_view network, std::vector<std::unique_ptr<Signer>> signers, const AccountId &account_id, const NearClientOptions &options = {});
+		NearClient(const NearClient &) = delete;
+		NearClient &operator=(const NearClient &) = delete;
+		~NearClient();
+
+		// Waits for the Lazy or Background startup to be done, and rethrows its error if it failed
+		void wait_started();
 
 		TransactionResult transaction(const std::string &recipient, const std::vector<schemas::Action> &actions);
+		// Broadcasts without waiting for execution and returns the base58 transaction hash
+		std::string transaction_async(const std::string &recipient, const std::vector<schemas::Action> &actions);
+		// Broadcasts without waiting and hands the hash over to the client's TransactionTracker
+		SubmittedTransaction submit(const std::string &recipient, const std::vector<schemas::Action> &actions, TxFinality finality = TxFinality::ExecutedOptimistic);
 		TransactionResult transfer(const std::string &recipient, const NearAmount &amount);
 		ContractCallResult contract_view(const std::string &contract_address, const std::string &method_name, const nlohmann::json &parameters = nlohmann::json::value_t::object);
+		ContractCallResult contract_view(const std::string &contract_address, const std::string &method_name, RawArgs args);
+		// Lighter contract_view variants that only return the view function output, without the rest of the query response
+		std::vector<uint8_t> contract_view_raw(const std::string &contract_address, const std::string &method_name, const nlohmann::json &parameters = nlohmann::json::value_t::object);
+		std::vector<uint8_t> contract_view_raw(const std::string &contract_address, const std::string &method_name, RawArgs args);
+		nlohmann::json contract_view_json(const std::string &contract_address, const std::string &method_name, const nlohmann::json &parameters = nlohmann::json::value_t::object);
+		nlohmann::json contract_view_json(const std::string &contract_address, const std::string &method_name, RawArgs args);
+		// For contracts returning Borsh, throws BorshDecodeError if the output is not exactly one T
+		template <class T>
+		T contract_view_borsh(const std::string &contract_address, const std::string &method_name, const nlohmann::json &parameters = nlohmann::json::value_t::object);
+		template <class T>
+		T contract_view_borsh(const std::string &contract_address, const std::string &method_name, RawArgs args);
 		ContractCallResult contract_call(const std::string &contract_address, const std::string &method_name, const nlohmann::json &parameters = nlohmann::json::value_t::object, const NearAmount &deposit = 0);
+		// Sends pre-serialized arguments (see RawArgs and BorshArgs) without going through a json value
+		ContractCallResult contract_call(const std::string &contract_address, const std::string &method_name, RawArgs args, const NearAmount &deposit = 0);
+
+		// Pre-encodes a call of `method_name` on `contract_address` by this account, to be sent repeatedly with contract_call
+		[[nodiscard]] TransactionTemplate function_call_template(const std::string &contract_address, const std::string &method_name) const;
+		ContractCallResult contract_call(const TransactionTemplate &transaction_template, const nlohmann::json &parameters = nlohmann::json::value_t::object, const NearAmount &deposit = 0);
+		ContractCallResult contract_call(const TransactionTemplate &transaction_template, RawArgs args, const NearAmount &deposit = 0);
+
+		template <class SignerClass, std::enable_if_t<std::is_base_of_v<Signer, std::decay_t<SignerClass>>, int> = 0>
+		void add_signer(SignerClass &&signing_method);
+		void add_signer(std::unique_ptr<Signer> signer);
+		// Adds `count` new full access keys to the account with AddKey actions and signs with them from now on
+		std::vector<ED25519Keypair> provision_access_keys(std::size_t count);
+		[[nodiscard]] std::size_t signers_count() const;
+
+		TransactionTracker &tracker();
+		// Exposes the response cache statistics set up through NearClientOptions::rpc
+		RPCClient &rpc();
+		NonceManager &nonces(std::size_t key_index = 0);
 
 		static std::string account_id_from_public_key(const std::array<uint8_t, 32> &public_key);
 		static std::string account_id_from_online_resolver(const std::string &resolver_url, const std::array<uint8_t, 32> &public_key); // see: https://github.com/near/near-indexer-for-explorer#shared-public-access// with: https://github.com/taocpp/taopq
 	};
 
 	template <class SignerClass>
-	NearClient::NearClient(const std::string_view network, SignerClass &&signing_method, const AccountId &account_id)
-		: m_network(network), m_rpc(_get_rpc_endpoint(network.data())), m_signer(std::make_unique<SignerClass>(std::move(signing_method)))
+	std::vector<std::unique_ptr<Signer>> NearClient::_make_signers(SignerClass &&signing_method)
+	{
+		std::vector<std::unique_ptr<Signer>> signers;
+		signers.push_back(std::make_unique<std::decay_t<SignerClass>>(std::forward<SignerClass>(signing_method)));
+		return signers;
+	}
+
+	template <class SignerClass, std::enable_if_t<std::is_base_of_v<Signer, std::decay_t<SignerClass>>, int>>
+	NearClient::NearClient(const std::string_view network, SignerClass &&signing_method, const AccountId &account_id, const NearClientOptions &options)
+		: NearClient(network, _make_signers(std::forward<SignerClass>(signing_method)), account_id, options)
+	{
+	}
+
+	template <class SignerClass, std::enable_if_t<std::is_base_of_v<Signer, std::decay_t<SignerClass>>, int>>
+	void NearClient::add_signer(SignerClass &&signing_method)
+	{
+		add_signer(std::make_unique<std::decay_t<SignerClass>>(std::forward<SignerClass>(signing_method)));
+	}
+
+	template <class T>
+	T NearClient::contract_view_borsh(const std::string &contract_address, const std::string &method_name, const nlohmann::json &parameters)
+	{
+		const std::string parameters_json = parameters.dump();
+		return contract_view_borsh<T>(contract_address, method_name, RawArgs(parameters_json));
+	}
+
+	template <class T>
+	T NearClient::contract_view_borsh(const std::string &contract_address, const std::string &method_name, RawArgs args)
 	{
-		_resolve_account_id(account_id);
-		_load_access_key();
+		const std::vector<uint8_t> bytes = _view_function(contract_address, method_name, args);
+		return BorshDecoder::DecodeExact<T>(bytes.data(), bytes.size());
 	}
 }
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <bignumber/bignumber.hpp>
+
+#include <ntb/near_utils.hpp>
+#include <ntb/uint128.hpp>
+
+namespace ntb
+{
+    // Amount of NEAR stored as an integer count of yoctoNEAR (10^-24 NEAR)
+    struct NearAmount
+    {
+    protected:
+        uint128 m_yocto;
+
+        constexpr explicit NearAmount(uint128 yocto_amount, int) : m_yocto(yocto_amount) {}
+
+    public:
+        // Every digit of the largest amount plus the decimal point
+        static constexpr std::size_t MAX_FORMATTED_SIZE = uint128::MAX_DECIMAL_DIGITS + 2;
+
+        constexpr NearAmount() = default;
+        NearAmount(int amount);
+        NearAmount(long long amount);
+        NearAmount(double amount);
+        NearAmount(const std::string &amount);
+        NearAmount(const char *amount);
+
+        static constexpr NearAmount from_yocto(uint128 yocto_amount)
+        {
+            return NearAmount(yocto_amount, 0);
+        }
+        static NearAmount from_yocto(const std::string &amount);
+
+        // Parses a decimal NEAR amount without allocating, commas and surrounding spaces are ignored
+        static constexpr std::optional<NearAmount> parse(std::string_view amount);
+        // Parses a plain decimal yoctoNEAR amount without allocating
+        static constexpr std::optional<NearAmount> parse_yocto(std::string_view amount);
+
+        [[nodiscard]] constexpr uint128 yocto() const
+        {
+            return m_yocto;
+        }
+
+        // Writes the amount in NEAR (e.g. "1.5") without allocating, returns nullptr if the buffer is too small
+        char *to_chars(char *first, char *last) const;
+        [[nodiscard]] std::string to_string() const;
+
+        constexpr std::optional<NearAmount> checked_add(const NearAmount &other) const
+        {
+            const auto sum = uint128::checked_add(m_yocto, other.m_yocto);
+            return sum ? std::optional<NearAmount>(from_yocto(*sum)) : std::nullopt;
+        }
+        constexpr std::optional<NearAmount> checked_sub(const NearAmount &other) const
+        {
+            const auto difference = uint128::checked_sub(m_yocto, other.m_yocto);
+            return difference ? std::optional<NearAmount>(from_yocto(*difference)) : std::nullopt;
+        }
+        constexpr std::optional<NearAmount> checked_mul(uint64_t factor) const
+        {
+            const auto product = uint128::checked_mul(m_yocto, factor);
+            return product ? std::optional<NearAmount>(from_yocto(*product)) : std::nullopt;
+        }
+
+        // Throwing variants of the checked operations
+        friend constexpr NearAmount operator+(const NearAmount &lhs, const NearAmount &rhs)
+        {
+            const auto sum = lhs.checked_add(rhs);
+            if (!sum)
+            {
+                throw std::overflow_error("NearAmount addition overflows 128 bits");
+            }
+            return *sum;
+        }
+        friend constexpr NearAmount operator-(const NearAmount &lhs, const NearAmount &rhs)
+        {
+            const auto difference = lhs.checked_sub(rhs);
+            if (!difference)
+            {
+                throw std::underflow_error("NearAmount subtraction would be negative");
+            }
+            return *difference;
+        }
+        friend constexpr NearAmount operator*(const NearAmount &lhs, uint64_t factor)
+        {
+            const auto product = lhs.checked_mul(factor);
+            if (!product)
+            {
+                throw std::overflow_error("NearAmount multiplication overflows 128 bits");
+            }
+            return *product;
+        }
+        constexpr NearAmount &operator+=(const NearAmount &other)
+        {
+            return *this = *this + other;
+        }
+        constexpr NearAmount &operator-=(const NearAmount &other)
+        {
+            return *this = *this - other;
+        }
+        constexpr NearAmount &operator*=(uint64_t factor)
+        {
+            return *this = *this * factor;
+        }
+
+        friend constexpr bool operator==(const NearAmount &lhs, const NearAmount &rhs)
+        {
+            return lhs.m_yocto == rhs.m_yocto;
+        }
+        friend constexpr bool operator!=(const NearAmount &lhs, const NearAmount &rhs)
+        {
+            return lhs.m_yocto != rhs.m_yocto;
+        }
+        friend constexpr bool operator<(const NearAmount &lhs, const NearAmount &rhs)
+        {
+            return lhs.m_yocto < rhs.m_yocto;
+        }
+        friend constexpr bool operator>(const NearAmount &lhs, const NearAmount &rhs)
+        {
+            return lhs.m_yocto > rhs.m_yocto;
+        }
+        friend constexpr bool operator<=(const NearAmount &lhs, const NearAmount &rhs)
+        {
+            return lhs.m_yocto <= rhs.m_yocto;
+        }
+        friend constexpr bool operator>=(const NearAmount &lhs, const NearAmount &rhs)
+        {
+            return lhs.m_yocto >= rhs.m_yocto;
+        }
+
+        operator BigNumber() const;
+        // Yocto amount as the u128 used by Borsh schemas
+        constexpr operator uint128() const
+        {
+            return m_yocto;
+        }
+    };
+
+    constexpr std::optional<NearAmount> NearAmount::parse(std::string_view amount)
+    {
+        uint128 yocto_amount;
+        bool has_digits = false;
+        bool in_fraction = false;
+        uint32_t fraction_digits = 0;
+
+        std::size_t begin = 0;
+        std::size_t end = amount.size();
+        while (begin < end && (amount[begin] == ' ' || amount[begin] == '\t' || amount[begin] == '\n' || amount[begin] == '\r'))
+        {
+            begin++;
+        }
+        while (end > begin && (amount[end - 1] == ' ' || amount[end - 1] == '\t' || amount[end - 1] == '\n' || amount[end - 1] == '\r'))
+        {
+            end--;
+        }
+
+        for (std::size_t i = begin; i < end; i++)
+        {
+            const char character = amount[i];
+            if (character == ',' || character == '\'')
+            {
+                continue;
+            }
+            if (character == '.')
+            {
+                if (in_fraction)
+                {
+                    return std::nullopt;
+                }
+                in_fraction = true;
+                continue;
+            }
+            if (character < '0' || character > '9')
+            {
+                return std::nullopt;
+            }
+            if (in_fraction && ++fraction_digits > NEAR_NOMINATION_EXP)
+            {
+                return std::nullopt;
+            }
+            const auto shifted = uint128::checked_mul(yocto_amount, 10);
+            const auto next = shifted ? uint128::checked_add(*shifted, static_cast<uint64_t>(character - '0')) : std::nullopt;
+            if (!next)
+            {
+                return std::nullopt;
+            }
+            yocto_amount = *next;
+            has_digits = true;
+        }
+        if (!has_digits)
+        {
+            return std::nullopt;
+        }
+
+        std::optional<uint128> result = yocto_amount;
+        for (uint32_t i = fraction_digits; i < NEAR_NOMINATION_EXP && result; i++)
+        {
+            result = uint128::checked_mul(*result, 10);
+        }
+        return result ? std::optional<NearAmount>(from_yocto(*result)) : std::nullopt;
+    }
+
+    constexpr std::optional<NearAmount> NearAmount::parse_yocto(std::string_view amount)
+    {
+        if (amount.empty())
+        {
+            return std::nullopt;
+        }
+        uint128 yocto_amount;
+        for (const char character : amount)
+        {
+            if (character == '\'')
+            {
+                continue;
+            }
+            if (character < '0' || character > '9')
+            {
+                return std::nullopt;
+            }
+            const auto shifted = uint128::checked_mul(yocto_amount, 10);
+            const auto next = shifted ? uint128::checked_add(*shifted, static_cast<uint64_t>(character - '0')) : std::nullopt;
+            if (!next)
+            {
+                return std::nullopt;
+            }
+            yocto_amount = *next;
+        }
+        return from_yocto(yocto_amount);
+    }
+
+    namespace literals
+    {
+        namespace detail
+        {
+            template <char... Characters>
+            struct NearAmountLiteral
+            {
+                static constexpr char text[] = {Characters...};
+                static constexpr std::optional<NearAmount> near = NearAmount::parse(std::string_view(text, sizeof...(Characters)));
+                static constexpr std::optional<NearAmount> yocto = NearAmount::parse_yocto(std::string_view(text, sizeof...(Characters)));
+            };
+        }
+
+        // 1.5_near, parsed exactly at compile time (no floating point rounding)
+        template <char... Characters>
+        constexpr NearAmount operator""_near()
+        {
+            static_assert(detail::NearAmountLiteral<Characters...>::near.has_value(), "invalid NEAR amount literal");
+            return *detail::NearAmountLiteral<Characters...>::near;
+        }
+
+        // 100_yocto, may exceed the range of unsigned long long
+        template <char... Characters>
+        constexpr NearAmount operator""_yocto()
+        {
+            static_assert(detail::NearAmountLiteral<Characters...>::yocto.has_value(), "invalid yoctoNEAR amount literal");
+            return *detail::NearAmountLiteral<Characters...>::yocto;
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace ntb
+{
+    // Hands out strictly increasing nonces for one (account, public key) pair
+    class NonceManager
+    {
+    private:
+        mutable std::mutex m_mutex;
+        uint64_t m_last_nonce = 0;
+        std::set<uint64_t> m_in_flight;
+
+    public:
+        NonceManager() = default;
+        NonceManager(const NonceManager &) = delete;
+        NonceManager &operator=(const NonceManager &) = delete;
+
+        // Shared by every client signing with the same access key in this process
+        static std::shared_ptr<NonceManager> for_access_key(const std::string &account_id, const std::string &public_key);
+
+        [[nodiscard]] uint64_t acquire();
+        void release(uint64_t nonce);
+        // Never moves backwards, nonces already handed out stay consumed
+        void sync(uint64_t chain_nonce);
+
+        [[nodiscard]] uint64_t last_nonce() const;
+        [[nodiscard]] std::size_t in_flight() const;
+        [[nodiscard]] bool is_in_flight(uint64_t nonce) const;
+    };
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace ntb
+{
+    struct HedgingOptions
+    {
+        bool enabled = false;
+        // Fixed wait before the request is also sent to a second endpoint, 0 derives it from the observed latencies
+        std::chrono::milliseconds delay = std::chrono::milliseconds(0);
+        double percentile = 0.95;
+        // Used until enough latencies are observed
+        std::chrono::milliseconds initial_delay = std::chrono::milliseconds(200);
+        std::chrono::milliseconds min_delay = std::chrono::milliseconds(1);
+        // Only read methods, sending them twice has no side effect
+        std::vector<std::string> methods = {"query", "block", "chunk", "tx", "EXPERIMENTAL_tx_status", "gas_price", "status", "validators"};
+    };
+
+    struct HedgeStats
+    {
+        // Requests that could be hedged
+        uint64_t requests = 0;
+        // Second requests sent, and how many of them answered first
+        uint64_t hedges = 0;
+        uint64_t hedge_wins = 0;
+        // Delay expired but no other endpoint had an idle connection
+        uint64_t skipped = 0;
+        std::chrono::microseconds delay = std::chrono::microseconds(0);
+    };
+
+    // Timing side of hedged requests: tracks the latency percentile and runs the delayed second requests
+    class RequestHedger
+    {
+    private:
+        struct Timer
+        {
+            std::chrono::steady_clock::time_point deadline;
+            std::function<void()> callback;
+
+            bool operator>(const Timer &other) const
+            {
+                return deadline > other.deadline;
+            }
+        };
+
+        static constexpr std::size_t LATENCY_WINDOW = 512;
+        static constexpr std::size_t MIN_LATENCY_SAMPLES = 32;
+        static constexpr std::size_t DELAY_UPDATE_INTERVAL = 32;
+
+        HedgingOptions m_options;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wakeup;
+        std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> m_timers;
+        std::vector<int64_t> m_latencies_us;
+        std::size_t m_next_latency = 0;
+        std::size_t m_samples_since_update = 0;
+        std::chrono::microseconds m_delay;
+        HedgeStats m_stats;
+        std::size_t m_running_tasks = 0;
+        std::condition_variable m_tasks_done;
+        bool m_stopping = false;
+        // Started only when hedging is enabled
+        std::thread m_thread;
+
+        void _run();
+        void _update_delay();
+
+    public:
+        explicit RequestHedger(const HedgingOptions &options = {});
+        RequestHedger(const RequestHedger &) = delete;
+        RequestHedger &operator=(const RequestHedger &) = delete;
+        // Drops pending timers and waits for the launched tasks
+        ~RequestHedger();
+
+        [[nodiscard]] bool applies_to(std::string_view method_name) const;
+        [[nodiscard]] std::chrono::microseconds delay() const;
+        void record_latency(std::chrono::steady_clock::duration latency);
+
+        // Calls `callback` on the timer thread once `deadline` is reached, it must not block
+        void schedule(std::chrono::steady_clock::time_point deadline, std::function<void()> callback);
+        // Runs `task` on a thread of its own, the destructor waits for it
+        void launch(std::function<void()> task);
+
+        void count_request();
+        void count_hedge();
+        void count_hedge_win();
+        void count_skipped();
+        [[nodiscard]] HedgeStats stats() const;
+    };
+}
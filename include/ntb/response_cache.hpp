@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace ntb
+{
+    struct ResponseCacheOptions
+    {
+        // Maximum amount of cached responses, 0 disables the cache
+        std::size_t capacity = 0;
+        // How long a "final" or "optimistic" answer is served when no newer block height has been seen
+        std::chrono::milliseconds max_age = std::chrono::seconds(1);
+        // view_access_key is left out by default, its nonce changes with every transaction
+        std::vector<std::string> request_types = {"call_function", "view_account", "view_code", "view_state"};
+    };
+
+    struct ResponseCacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        // Entries dropped because a newer block was seen or max_age passed
+        uint64_t expired = 0;
+        std::size_t entries = 0;
+    };
+
+    // LRU cache of successful query response bodies, safe to share between threads.
+    // Answers for an explicit block_id never change, answers for a finality expire once a newer block height is seen for it
+    class ResponseCache
+    {
+    private:
+        struct Entry
+        {
+            std::string key;
+            std::string body;
+            // Empty for block_id queries
+            std::string finality;
+            uint64_t block_height;
+            std::chrono::steady_clock::time_point stored_at;
+        };
+
+        ResponseCacheOptions m_options;
+        mutable std::mutex m_mutex;
+        // Most recently used first, list nodes never move so the index can view their keys
+        std::list<Entry> m_entries;
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index;
+        std::unordered_map<std::string, uint64_t> m_latest_block_heights;
+        ResponseCacheStats m_stats;
+
+        bool _is_expired(const Entry &entry, std::chrono::steady_clock::time_point now) const;
+        void _erase(std::list<Entry>::iterator it);
+
+    public:
+        explicit ResponseCache(const ResponseCacheOptions &options = {});
+        ResponseCache(const ResponseCache &) = delete;
+        ResponseCache &operator=(const ResponseCache &) = delete;
+
+        // Canonical key of a query, built from all of its parameters. Empty if the query is not cacheable
+        [[nodiscard]] std::string key(const nlohmann::json &parameters) const;
+        // Copies the cached body of `key` to `body`, counts a hit or a miss
+        bool get(const std::string &key, std::string &body);
+        // Stores a successful response body, RPC and contract errors are ignored
+        void put(const std::string &key, const nlohmann::json &parameters, const std::string &body);
+        // Expires the entries of `finality` older than `block_height`
+        void observe_block_height(std::string_view finality, uint64_t block_height);
+        void clear();
+
+        [[nodiscard]] ResponseCacheStats stats() const;
+    };
+}
@@ -1,11 +1,19 @@
 #pragma once
 
+#include <atomic>
 #include <string>
+#include <vector>
 
 #include <httplib/httplib.h>
 #include <nlohmann/json.hpp>
 #include <result/result.hpp>
 
+#include <ntb/connection_pool.hpp>
+#include <ntb/endpoint_set.hpp>
+#include <ntb/request_hedger.hpp>
+#include <ntb/response_cache.hpp>
+#include <ntb/single_flight.hpp>
+
 namespace ntb
 {
     struct RPCSuccess
@@ -20,17 +28,87 @@ namespace ntb
 
     using RPCResponse = cpp::result<RPCSuccess, RPCError>;
 
+    struct RPCRequest
+    {
+        std::string method_name;
+        nlohmann::json parameters;
+    };
+
+    struct RPCClientOptions
+    {
+        // Per endpoint
+        ConnectionPoolOptions connections;
+        EndpointHealthOptions health;
+        std::size_t max_batch_size = 100;
+        // Applies to query and query_unparsed, disabled by default
+        ResponseCacheOptions cache;
+        // Needs at least two endpoints, disabled by default
+        HedgingOptions hedging;
+        // Disabled by default
+        SingleFlightOptions single_flight;
+    };
+
+    // Thread-safe: every call checks out its own keep-alive connection from the pool of the endpoint it is sent to
     class RPCClient
     {
     private:
-        std::string m_endpoint;
-        httplib::Client m_client;
+        struct HedgedRequest;
+
+        enum class BatchOutcome
+        {
+            Answered,
+            // Transient failure, only this chunk falls back to single requests
+            Failed,
+            // The endpoint rejects batch payloads, every later batch falls back too
+            Unsupported,
+        };
+
+        EndpointSet m_endpoints;
+        std::size_t m_max_batch_size;
+        std::atomic<bool> m_batch_supported = true;
+        ResponseCache m_cache;
+        SingleFlight m_single_flight;
+        // After m_endpoints so hedged requests still running are done before the connection pools go away
+        RequestHedger m_hedger;
+
+        static bool _is_failure(const httplib::Result &resp);
+        httplib::Result _post(const std::string &body, bool idempotent = false);
+        httplib::Result _send(std::size_t endpoint_index, const std::string &body);
+        httplib::Result _send_hedged(std::size_t endpoint_index, const std::string &body, std::vector<bool> &tried);
+        void _start_hedge(const std::shared_ptr<HedgedRequest> &request);
+        void _complete(HedgedRequest &request, std::size_t slot, httplib::Result resp, std::chrono::steady_clock::duration latency);
+        // Sends a request built by _request_body, sharing the answer with identical requests in flight if enabled
+        RawResponse _post_request(const std::string &method_name, const std::string &body);
+        static RawResponse _to_raw(httplib::Result resp);
+        static RPCResponse _to_response(const RawResponse &resp);
+        static std::string _request_body(const std::string &method_name, const nlohmann::json &parameters);
+        static RPCResponse _parse_response(const nlohmann::json &result_or_error);
+        BatchOutcome _call_batch_chunk(const std::vector<RPCRequest> &requests, std::size_t begin, std::size_t end, std::vector<RPCResponse> &responses);
+        void _call_parallel(const std::vector<RPCRequest> &requests, std::size_t begin, std::size_t end, std::vector<RPCResponse> &responses);
 
     public:
-        RPCClient(const std::string &endpoint);
+        RPCClient(const std::string &endpoint, const RPCClientOptions &options = {});
+        // Each request goes to the fastest healthy endpoint and fails over to the next one on transport errors and 5xx/429 statuses
+        RPCClient(const std::vector<std::string> &endpoints, const RPCClientOptions &options = {});
 
         httplib::Result call_raw(const nlohmann::json &payload);
         RPCResponse call(const std::string &method_name, const nlohmann::json &payload);
+        // Sends an already serialized JSON-RPC request body, such as the one built by TransactionBuilder
+        RPCResponse call_serialized(const std::string &body);
+        // Returns the body of a successful HTTP response as is, for callers that extract what they need without a full parse
+        cpp::result<std::string, RPCError> call_unparsed(const std::string &method_name, const nlohmann::json &parameters);
         RPCResponse query(const nlohmann::json &parameters);
+        cpp::result<std::string, RPCError> query_unparsed(const nlohmann::json &parameters);
+
+        // Sends the requests as JSON-RPC batches (falls back to parallel single calls if the endpoint rejects batches)
+        std::vector<RPCResponse> call_batch(const std::vector<RPCRequest> &requests);
+        // Not cached, every query is sent
+        std::vector<RPCResponse> query_batch(const std::vector<nlohmann::json> &parameters);
+
+        [[nodiscard]] ResponseCacheStats cache_stats() const;
+        [[nodiscard]] std::vector<EndpointStats> endpoint_stats() const;
+        [[nodiscard]] HedgeStats hedge_stats() const;
+        [[nodiscard]] SingleFlightStats single_flight_stats() const;
+        void clear_cache();
     };
-}
\ No newline at end of file
+}
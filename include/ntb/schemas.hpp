@@ -1,55 +1,84 @@
 #pragma once
 
 #include <array>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <variant>
+#include <vector>
 
 #include <bignumber/bignumber.hpp>
+#include <borsh/borsh.hpp>
 #include <borsh/visit_struct.hpp>
 
 #include <ntb/encoders.hpp>
+#include <ntb/uint128.hpp>
 
 
 namespace ntb::schemas
 {
+    constexpr uint8_t ED25519_KEY_SIZE = 32;
+
+    struct ED25519PublicKey {
+        std::array<uint8_t, ED25519_KEY_SIZE> data;
+    };
+
+    using PublicKey = std::variant<ED25519PublicKey>;
+
+    struct FunctionCallPermission {
+        std::optional<uint128> allowance;
+        std::string receiver_id;
+        std::vector<std::string> method_names;
+    };
+
+    struct FullAccessPermission {
+    };
+
+    using AccessKeyPermission = std::variant<FunctionCallPermission, FullAccessPermission>;
+
+    struct AccessKey {
+        uint64_t nonce;
+        AccessKeyPermission permission;
+    };
+
     struct CreateAccount {
     };
 
     struct DeployContract {
+        std::vector<uint8_t> code;
     };
 
     struct FunctionCall {
         std::string method_name;
         std::vector<uint8_t> args;
         uint64_t gas;
-        BigNumber deposit; // TODO: specify dump size (here u128)
+        uint128 deposit;
     };
 
     struct Transfer {
-        BigNumber deposit; // TODO: specify dump size (here u128)
+        uint128 deposit;
     };
 
     struct Stake {
+        uint128 stake;
+        PublicKey public_key;
     };
 
     struct AddKey {
+        PublicKey public_key;
+        AccessKey access_key;
     };
 
     struct DeleteKey {
+        PublicKey public_key;
     };
 
     struct DeleteAccount {
+        std::string beneficiary_id;
     };
 
     using Action = std::variant<CreateAccount, DeployContract, FunctionCall, Transfer, Stake, AddKey, DeleteKey, DeleteAccount>;
 
-    constexpr uint8_t ED25519_KEY_SIZE = 32;
-
-    struct ED25519PublicKey {
-        std::array<uint8_t, ED25519_KEY_SIZE> data;
-    };
-
-    using PublicKey = std::variant<ED25519PublicKey>;
-
     struct Transaction {
         std::string signer_id;
         PublicKey public_key;
@@ -75,17 +104,70 @@ namespace ntb::schemas
         Transaction transaction;
         Signature signature;
     };
+
+    // Zero-copy variants of the transaction schemas for BorshDecoder, their strings and byte vectors point into
+    // the decoded buffer, which must outlive them. They encode to the same bytes as the owning schemas.
+    // AddKey is kept owning, its FunctionCallPermission method names are rarely on a hot path
+    struct DeployContractView {
+        BorshBytesView code;
+    };
+
+    struct FunctionCallView {
+        std::string_view method_name;
+        BorshBytesView args;
+        uint64_t gas;
+        uint128 deposit;
+    };
+
+    struct DeleteAccountView {
+        std::string_view beneficiary_id;
+    };
+
+    using ActionView = std::variant<CreateAccount, DeployContractView, FunctionCallView, Transfer, Stake, AddKey, DeleteKey, DeleteAccountView>;
+
+    struct TransactionView {
+        std::string_view signer_id;
+        PublicKey public_key;
+        uint64_t nonce;
+        std::string_view receiver_id;
+        std::array<uint8_t, 32> block_hash;
+        std::vector<ActionView> actions;
+    };
+
+    struct SignedTransactionView
+    {
+        TransactionView transaction;
+        Signature signature;
+    };
+
+    // NEP-413 signMessage payload
+    struct Nep413Payload
+    {
+        std::string message;
+        std::array<uint8_t, 32> nonce;
+        std::string recipient;
+        std::optional<std::string> callback_url;
+    };
 }
 
+VISITABLE_STRUCT(ntb::schemas::ED25519PublicKey, data);
+VISITABLE_STRUCT(ntb::schemas::FunctionCallPermission, allowance, receiver_id, method_names);
+VISITABLE_EMPTY_STRUCT(ntb::schemas::FullAccessPermission);
+VISITABLE_STRUCT(ntb::schemas::AccessKey, nonce, permission);
 VISITABLE_EMPTY_STRUCT(ntb::schemas::CreateAccount);
-VISITABLE_EMPTY_STRUCT(ntb::schemas::DeployContract);
+VISITABLE_STRUCT(ntb::schemas::DeployContract, code);
 VISITABLE_STRUCT(ntb::schemas::FunctionCall, method_name, args, gas, deposit);
 VISITABLE_STRUCT(ntb::schemas::Transfer, deposit);
-VISITABLE_EMPTY_STRUCT(ntb::schemas::Stake);
-VISITABLE_EMPTY_STRUCT(ntb::schemas::AddKey);
-VISITABLE_EMPTY_STRUCT(ntb::schemas::DeleteKey);
-VISITABLE_EMPTY_STRUCT(ntb::schemas::DeleteAccount);
-VISITABLE_STRUCT(ntb::schemas::ED25519PublicKey, data);
+VISITABLE_STRUCT(ntb::schemas::Stake, stake, public_key);
+VISITABLE_STRUCT(ntb::schemas::AddKey, public_key, access_key);
+VISITABLE_STRUCT(ntb::schemas::DeleteKey, public_key);
+VISITABLE_STRUCT(ntb::schemas::DeleteAccount, beneficiary_id);
 VISITABLE_STRUCT(ntb::schemas::Transaction, signer_id, public_key, nonce, receiver_id, block_hash, actions);
 VISITABLE_STRUCT(ntb::schemas::Signature, key_type, data);
-VISITABLE_STRUCT(ntb::schemas::SignedTransaction, transaction, signature);
\ No newline at end of file
+VISITABLE_STRUCT(ntb::schemas::SignedTransaction, transaction, signature);
+VISITABLE_STRUCT(ntb::schemas::DeployContractView, code);
+VISITABLE_STRUCT(ntb::schemas::FunctionCallView, method_name, args, gas, deposit);
+VISITABLE_STRUCT(ntb::schemas::DeleteAccountView, beneficiary_id);
+VISITABLE_STRUCT(ntb::schemas::TransactionView, signer_id, public_key, nonce, receiver_id, block_hash, actions);
+VISITABLE_STRUCT(ntb::schemas::SignedTransactionView, transaction, signature);
+VISITABLE_STRUCT(ntb::schemas::Nep413Payload, message, nonce, recipient, callback_url);
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <ntb/schemas.hpp>
+
+namespace ntb
+{
+    // Signature of a message, the message itself is viewed rather than owned
+    struct SignatureCheck
+    {
+        const uint8_t *message;
+        std::size_t message_size;
+        std::array<uint8_t, 64> signature;
+        std::array<uint8_t, 32> public_key;
+    };
+
+    struct SignatureVerifierOptions
+    {
+        // Decompressed public keys kept for repeat signers
+        std::size_t public_key_cache_size = 4096;
+        // A batch holding an invalid signature is checked again one signature at a time, smaller batches bound that cost
+        std::size_t batch_size = 128;
+    };
+
+    // ED25519 verification with batched multi-scalar checks, safe to share between threads.
+    // verify and verify_batch use the same cofactored equation, a signature is accepted alone exactly when it is in a batch
+    class SignatureVerifier
+    {
+    private:
+        class PublicKeyCache;
+
+        SignatureVerifierOptions m_options;
+        std::unique_ptr<PublicKeyCache> m_public_keys;
+
+    public:
+        explicit SignatureVerifier(const SignatureVerifierOptions &options = {});
+        SignatureVerifier(const SignatureVerifier &) = delete;
+        SignatureVerifier &operator=(const SignatureVerifier &) = delete;
+        ~SignatureVerifier();
+
+        [[nodiscard]] bool verify(const uint8_t *message, std::size_t message_size, const std::array<uint8_t, 64> &signature, const std::array<uint8_t, 32> &public_key) const;
+        // Sets results[i] to whether checks[i] is valid and returns true if all of them are
+        bool verify_batch(const SignatureCheck *checks, std::size_t count, bool *results) const;
+        [[nodiscard]] std::vector<bool> verify_batch(const std::vector<SignatureCheck> &checks) const;
+
+        // Checks a NEP-413 signMessage signature, as returned by wallets for `payload`
+        [[nodiscard]] bool verify_nep413(const schemas::Nep413Payload &payload, const std::array<uint8_t, 64> &signature, const std::array<uint8_t, 32> &public_key) const;
+
+        [[nodiscard]] std::size_t cached_public_keys() const;
+    };
+
+    // What wallets sign for a NEP-413 payload: sha256 of the Borsh encoded tag 2^31 + 413 followed by the payload
+    [[nodiscard]] std::array<uint8_t, 32> nep413_payload_hash(const schemas::Nep413Payload &payload);
+}
@@ -5,15 +5,25 @@
 #endif
 
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <nearledger/ledger.hpp>
 
+#include <ntb/thread_pool.hpp>
+
 // #define NTB_ENABLE_LEDGER
 
 namespace ntb
 {
+    // Non-owning view on one message of a batch
+    struct SignerMessage
+    {
+        const uint8_t *data;
+        std::size_t size;
+    };
+
     class Signer
     {
     public:
@@ -22,6 +32,12 @@ namespace ntb
         [[nodiscard]] virtual std::string get_public_key_as_b58() const = 0;
         [[nodiscard]] virtual std::array<uint8_t, 32> get_public_key() const = 0;
         [[nodiscard]] virtual std::array<uint8_t, 64> sign(const std::vector<uint8_t> &msg) const = 0;
+        // Signs without requiring the message to be in a std::vector, the default implementation copies it into one
+        [[nodiscard]] virtual std::array<uint8_t, 64> sign(const uint8_t *msg, std::size_t msg_size) const;
+        // Writes the signature of messages[i] to signatures[i], the default implementation signs them one after the other
+        virtual void sign_batch(const SignerMessage *messages, std::size_t count, std::array<uint8_t, 64> *signatures) const;
+        [[nodiscard]] std::vector<std::array<uint8_t, 64>> sign_batch(const std::vector<SignerMessage> &messages) const;
+        [[nodiscard]] std::vector<std::array<uint8_t, 64>> sign_batch(const std::vector<std::vector<uint8_t>> &messages) const;
     };
 
     class ED25519Keypair : public Signer
@@ -29,6 +45,7 @@ namespace ntb
     private:
         std::array<uint8_t, 64> m_private_key;
         std::array<uint8_t, 32> m_public_key;
+        std::shared_ptr<ThreadPool> m_thread_pool;
 
     public:
         ED25519Keypair(const std::string &b58_encoded_private_key_or_seed);
@@ -40,6 +57,13 @@ namespace ntb
         [[nodiscard]] std::string get_public_key_as_b58() const override;
         [[nodiscard]] std::array<uint8_t, 32> get_public_key() const override;
         [[nodiscard]] std::array<uint8_t, 64> sign(const std::vector<uint8_t> &msg) const override;
+        [[nodiscard]] std::array<uint8_t, 64> sign(const uint8_t *msg, std::size_t msg_size) const override;
+        using Signer::sign_batch;
+        // Spreads the batch over the keypair's thread pool
+        void sign_batch(const SignerMessage *messages, std::size_t count, std::array<uint8_t, 64> *signatures) const override;
+
+        // Pool used by sign_batch, ThreadPool::shared() unless set
+        void set_thread_pool(std::shared_ptr<ThreadPool> thread_pool);
 
         [[nodiscard]] std::string get_private_key_as_b58() const;
         [[nodiscard]] std::array<uint8_t, 64> get_private_key() const;
@@ -58,6 +82,9 @@ namespace ntb
     public:
         LedgerWallet(const std::string &derivation_path = NEAR_DERIVATION_PATH.data());
 
+        using Signer::sign;
+        // The device signs one message at a time, so sign_batch keeps the sequential default
+
         [[nodiscard]] std::string get_public_key_as_b58() const override;
         [[nodiscard]] std::array<uint8_t, 32> get_public_key() const override;
         [[nodiscard]] std::array<uint8_t, 64> sign(const std::vector<uint8_t> &msg) const override;
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <httplib/httplib.h>
+
+namespace ntb
+{
+    struct SingleFlightOptions
+    {
+        bool enabled = false;
+        // Only read methods, a waiter gets the answer of a request sent before it asked
+        std::vector<std::string> methods = {"query", "block", "chunk", "tx", "EXPERIMENTAL_tx_status", "gas_price", "status", "validators"};
+    };
+
+    struct SingleFlightStats
+    {
+        // Requests that could be coalesced, and how many of them waited for an identical one instead of being sent
+        uint64_t requests = 0;
+        uint64_t coalesced = 0;
+    };
+
+    // HTTP answer to an RPC request, in a form that can be handed to several waiters
+    struct RawResponse
+    {
+        httplib::Error error;
+        int status;
+        std::string body;
+    };
+
+    // Makes concurrent identical requests share one network call, nothing is kept once it completes
+    class SingleFlight
+    {
+    private:
+        SingleFlightOptions m_options;
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, std::shared_future<std::shared_ptr<const RawResponse>>> m_in_flight;
+        SingleFlightStats m_stats;
+
+    public:
+        explicit SingleFlight(const SingleFlightOptions &options = {});
+        SingleFlight(const SingleFlight &) = delete;
+        SingleFlight &operator=(const SingleFlight &) = delete;
+
+        [[nodiscard]] bool applies_to(std::string_view method_name) const;
+        // Calls `send` unless a request with the same `key` is in flight, in which case its response (or exception) is shared
+        std::shared_ptr<const RawResponse> run(const std::string &key, const std::function<RawResponse()> &send);
+
+        [[nodiscard]] SingleFlightStats stats() const;
+    };
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ntb
+{
+    // Fixed set of worker threads for CPU bound work such as batch signing
+    class ThreadPool
+    {
+    private:
+        std::vector<std::thread> m_workers;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_task_available;
+        bool m_stopping = false;
+
+        void _worker_loop();
+
+    public:
+        // 0 means one worker per hardware thread
+        explicit ThreadPool(std::size_t threads_count = 0);
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+        ~ThreadPool();
+
+        // Process wide pool sized to the hardware, created on first use
+        static std::shared_ptr<ThreadPool> shared();
+
+        // Calls `func(begin, end)` on chunks of at least `min_chunk_size` items covering [0, count).
+        // The calling thread works on chunks too and returns once all of them are done, rethrowing the first exception
+        void parallel_for(std::size_t count, std::size_t min_chunk_size, const std::function<void(std::size_t, std::size_t)> &func);
+
+        [[nodiscard]] std::size_t size() const;
+    };
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <ntb/schemas.hpp>
+#include <ntb/signer.hpp>
+
+namespace ntb
+{
+    // Serializes, signs and wraps transactions into buffers that keep their capacity from one build to the next,
+    // so once they are warm a build does not touch the heap
+    class TransactionBuilder
+    {
+    private:
+        std::vector<uint8_t> m_signed_transaction;
+        std::string m_rpc_body;
+        std::array<uint8_t, 32> m_hash = {};
+
+        friend class TransactionTemplate;
+
+    public:
+        // Instance owned by the calling thread, used by NearClient for every transaction it sends
+        static TransactionBuilder &for_current_thread();
+
+        // Encodes the transaction once, signs its hash and appends the signature in place
+        void build(const Signer &signer, const std::string &signer_id, const std::array<uint8_t, 32> &public_key, uint64_t nonce,
+                   const std::string &receiver_id, const std::array<uint8_t, 32> &block_hash, const std::vector<schemas::Action> &actions);
+
+        // JSON-RPC request body sending the last built transaction, with its base64 encoding written directly into the body
+        const std::string &rpc_body(std::string_view method_name);
+
+        // Borsh encoded SignedTransaction of the last build
+        [[nodiscard]] const std::vector<uint8_t> &signed_transaction() const;
+        [[nodiscard]] const std::array<uint8_t, 32> &hash() const;
+    };
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sha256/sha256.hpp>
+
+#include <ntb/signer.hpp>
+#include <ntb/transaction_builder.hpp>
+#include <ntb/uint128.hpp>
+
+namespace ntb
+{
+    // Single FunctionCall transaction whose signer, receiver and method never change. Their Borsh encoding is
+    // computed once, and so is the SHA-256 state after the leading signer id and public key of each access key.
+    class TransactionTemplate
+    {
+    private:
+        struct KeyPrefix
+        {
+            std::array<uint8_t, 32> public_key;
+            std::vector<uint8_t> bytes;
+            sha256::SHA256 midstate;
+        };
+
+        std::string m_signer_id;
+        std::string m_receiver_id;
+        std::string m_method_name;
+        // Borsh receiver_id
+        std::vector<uint8_t> m_receiver_segment;
+        // Borsh actions length, FunctionCall variant index and method_name
+        std::vector<uint8_t> m_action_segment;
+        mutable std::mutex m_prefixes_mutex;
+        mutable std::vector<std::unique_ptr<KeyPrefix>> m_prefixes;
+
+        const KeyPrefix &_prefix(const std::array<uint8_t, 32> &public_key) const;
+
+    public:
+        TransactionTemplate(const std::string &signer_id, const std::string &receiver_id, const std::string &method_name);
+
+        [[nodiscard]] const std::string &signer_id() const;
+        [[nodiscard]] const std::string &receiver_id() const;
+        [[nodiscard]] const std::string &method_name() const;
+
+        // Same output as TransactionBuilder::build, only the nonce, block hash, args, gas and deposit are encoded per call
+        void build(TransactionBuilder &builder, const Signer &signer, const std::array<uint8_t, 32> &public_key, uint64_t nonce,
+                   const std::array<uint8_t, 32> &block_hash, const uint8_t *args, std::size_t args_size, uint64_t gas, const uint128 &deposit) const;
+    };
+}
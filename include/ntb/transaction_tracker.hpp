@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ntb/rpc.hpp>
+
+namespace ntb
+{
+    // Same ordering as NEAR's TxExecutionStatus
+    enum class TxFinality
+    {
+        Included,
+        ExecutedOptimistic,
+        IncludedFinal,
+        Executed,
+        Final,
+    };
+
+    std::string_view tx_finality_to_string(TxFinality finality);
+
+    struct TransactionTrackerOptions
+    {
+        std::chrono::milliseconds poll_interval = std::chrono::milliseconds(500);
+        std::chrono::milliseconds timeout = std::chrono::seconds(120);
+        bool use_experimental_tx_status = false; // also fetches receipts
+    };
+
+    // Polls the outcome of many broadcast transactions together, using one batched RPC call per poll
+    class TransactionTracker
+    {
+    public:
+        using Callback = std::function<void(RPCResponse)>;
+
+    private:
+        struct PendingTransaction
+        {
+            std::string hash;
+            std::string sender_id;
+            TxFinality finality;
+            std::chrono::steady_clock::time_point deadline;
+            Callback callback;
+        };
+
+        RPCClient &m_rpc;
+        TransactionTrackerOptions m_options;
+        std::vector<PendingTransaction> m_pending;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wakeup;
+        std::thread m_thread;
+        bool m_stopping = false;
+
+        void _run();
+        void _poll(std::vector<PendingTransaction> &pending);
+        static bool _reached_finality(const nlohmann::json &outcome, TxFinality finality);
+        static bool _is_transient_error(const RPCError &error);
+
+    public:
+        explicit TransactionTracker(RPCClient &rpc, const TransactionTrackerOptions &options = {});
+        TransactionTracker(const TransactionTracker &) = delete;
+        TransactionTracker &operator=(const TransactionTracker &) = delete;
+        ~TransactionTracker();
+
+        void track(const std::string &tx_hash, const std::string &sender_id, TxFinality finality, Callback callback);
+        std::future<RPCResponse> track(const std::string &tx_hash, const std::string &sender_id, TxFinality finality = TxFinality::ExecutedOptimistic);
+        [[nodiscard]] std::size_t pending() const;
+    };
+}
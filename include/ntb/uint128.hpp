@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <borsh/visit_struct.hpp>
+
+namespace ntb
+{
+    // Portable unsigned 128-bit integer, Borsh-encoded as 16 little-endian bytes like NEAR's u128 balances
+    struct uint128
+    {
+        uint64_t low = 0;
+        uint64_t high = 0;
+
+        constexpr uint128() = default;
+        constexpr uint128(uint64_t value) : low(value) {}
+        constexpr uint128(uint64_t high_part, uint64_t low_part) : low(low_part), high(high_part) {}
+
+        static constexpr uint128 max()
+        {
+            return uint128(UINT64_MAX, UINT64_MAX);
+        }
+
+        // Full 64x64 -> 128 bits product
+        static constexpr uint128 multiply(uint64_t lhs, uint64_t rhs)
+        {
+            const uint64_t lhs_low = lhs & 0xffffffff;
+            const uint64_t lhs_high = lhs >> 32;
+            const uint64_t rhs_low = rhs & 0xffffffff;
+            const uint64_t rhs_high = rhs >> 32;
+
+            const uint64_t low_low = lhs_low * rhs_low;
+            const uint64_t low_high = lhs_low * rhs_high;
+            const uint64_t high_low = lhs_high * rhs_low;
+            const uint64_t high_high = lhs_high * rhs_high;
+
+            const uint64_t middle = (low_low >> 32) + (low_high & 0xffffffff) + (high_low & 0xffffffff);
+            return uint128(high_high + (low_high >> 32) + (high_low >> 32) + (middle >> 32), (low_low & 0xffffffff) | (middle << 32));
+        }
+
+        // Returns the quotient and the remainder, the divisor fits in 32 bits so every step stays in 64 bits
+        [[nodiscard]] constexpr std::pair<uint128, uint32_t> divmod(uint32_t divisor) const
+        {
+            const uint32_t limbs[4] = {
+                static_cast<uint32_t>(high >> 32), static_cast<uint32_t>(high),
+                static_cast<uint32_t>(low >> 32), static_cast<uint32_t>(low)};
+            uint32_t quotient[4] = {};
+            uint64_t remainder = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                const uint64_t current = (remainder << 32) | limbs[i];
+                quotient[i] = static_cast<uint32_t>(current / divisor);
+                remainder = current % divisor;
+            }
+            return {uint128((static_cast<uint64_t>(quotient[0]) << 32) | quotient[1], (static_cast<uint64_t>(quotient[2]) << 32) | quotient[3]),
+                    static_cast<uint32_t>(remainder)};
+        }
+
+        [[nodiscard]] constexpr bool is_zero() const
+        {
+            return low == 0 && high == 0;
+        }
+
+        static constexpr std::optional<uint128> checked_add(const uint128 &lhs, const uint128 &rhs)
+        {
+            const uint128 sum = lhs + rhs;
+            if (sum < lhs)
+            {
+                return std::nullopt;
+            }
+            return sum;
+        }
+
+        static constexpr std::optional<uint128> checked_sub(const uint128 &lhs, const uint128 &rhs)
+        {
+            if (lhs < rhs)
+            {
+                return std::nullopt;
+            }
+            return lhs - rhs;
+        }
+
+        static constexpr std::optional<uint128> checked_mul(const uint128 &lhs, uint64_t rhs)
+        {
+            const uint128 low_product = multiply(lhs.low, rhs);
+            const uint128 high_product = multiply(lhs.high, rhs);
+            const uint64_t high = low_product.high + high_product.low;
+            if (high_product.high != 0 || high < low_product.high)
+            {
+                return std::nullopt;
+            }
+            return uint128(high, low_product.low);
+        }
+
+        static constexpr uint128 pow10(uint32_t exponent)
+        {
+            uint128 value = 1;
+            for (uint32_t i = 0; i < exponent; i++)
+            {
+                value = value * 10;
+            }
+            return value;
+        }
+
+        // 2^128 - 1 has 39 decimal digits
+        static constexpr std::size_t MAX_DECIMAL_DIGITS = 39;
+
+        // Parses a plain decimal string, std::nullopt on any other character or on overflow
+        static std::optional<uint128> from_string(std::string_view decimal);
+        // Writes the decimal digits without allocating, returns nullptr if the buffer is too small
+        char *to_chars(char *first, char *last) const;
+        [[nodiscard]] std::string to_string() const;
+
+        friend constexpr bool operator==(const uint128 &lhs, const uint128 &rhs)
+        {
+            return lhs.low == rhs.low && lhs.high == rhs.high;
+        }
+        friend constexpr bool operator!=(const uint128 &lhs, const uint128 &rhs)
+        {
+            return !(lhs == rhs);
+        }
+        friend constexpr bool operator<(const uint128 &lhs, const uint128 &rhs)
+        {
+            return lhs.high < rhs.high || (lhs.high == rhs.high && lhs.low < rhs.low);
+        }
+        friend constexpr bool operator>(const uint128 &lhs, const uint128 &rhs)
+        {
+            return rhs < lhs;
+        }
+        friend constexpr bool operator<=(const uint128 &lhs, const uint128 &rhs)
+        {
+            return !(rhs < lhs);
+        }
+        friend constexpr bool operator>=(const uint128 &lhs, const uint128 &rhs)
+        {
+            return !(lhs < rhs);
+        }
+
+        // Wrapping arithmetic, like the built-in unsigned types
+        friend constexpr uint128 operator+(const uint128 &lhs, const uint128 &rhs)
+        {
+            const uint64_t low = lhs.low + rhs.low;
+            return uint128(lhs.high + rhs.high + (low < lhs.low ? 1 : 0), low);
+        }
+        friend constexpr uint128 operator-(const uint128 &lhs, const uint128 &rhs)
+        {
+            return uint128(lhs.high - rhs.high - (lhs.low < rhs.low ? 1 : 0), lhs.low - rhs.low);
+        }
+        friend constexpr uint128 operator*(const uint128 &lhs, uint64_t rhs)
+        {
+            uint128 product = multiply(lhs.low, rhs);
+            product.high += lhs.high * rhs;
+            return product;
+        }
+    };
+}
+
+VISITABLE_STRUCT(ntb::uint128, low, high);
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace ntb
+{
+    // Appends the bytes of the "result" array of a call_function query response body to `out` without building a json tree.
+    // Returns false and leaves `out` as it was if the body holds no such array, as with RPC or contract errors
+    bool scan_view_result(std::string_view body, std::vector<uint8_t> &out);
+    // Reads result.block_height of a query response body, returns false for RPC errors and results holding an "error"
+    bool scan_query_block_height(std::string_view body, uint64_t &block_height);
+}
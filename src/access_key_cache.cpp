@@ -0,0 +1,107 @@
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+#include <nlohmann/json.hpp>
+
+#include <ntb/access_key_cache.hpp>
+
+namespace ntb
+{
+    namespace
+    {
+        // Clients of the same process sharing a file do not overwrite each other's updates
+        std::mutex cache_files_mutex;
+
+        nlohmann::json read_cache_file(const std::string &path)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+            {
+                return nlohmann::json::object();
+            }
+            nlohmann::json content = nlohmann::json::parse(file, nullptr, false);
+            return content.is_object() ? content : nlohmann::json::object();
+        }
+    }
+
+    AccessKeyCache::AccessKeyCache(std::string path)
+        : m_path(std::move(path))
+    {
+    }
+
+    std::map<std::string, CachedAccessKey> AccessKeyCache::load(const std::string &network, const std::string &account_id) const
+    {
+        nlohmann::json content;
+        {
+            std::lock_guard lock(cache_files_mutex);
+            content = read_cache_file(m_path);
+        }
+
+        std::map<std::string, CachedAccessKey> access_keys;
+        const auto network_it = content.find(network);
+        if (network_it == content.end() || !network_it->is_object())
+        {
+            return access_keys;
+        }
+        const auto account_it = network_it->find(account_id);
+        if (account_it == network_it->end() || !account_it->is_object())
+        {
+            return access_keys;
+        }
+        for (auto it = account_it->begin(); it != account_it->end(); ++it)
+        {
+            const nlohmann::json &entry = it.value();
+            // Entries written by something else are skipped rather than trusted
+            if (!entry.is_object() || !entry.value("permission", nlohmann::json()).is_string() || !entry.value("nonce", nlohmann::json()).is_number_unsigned() ||
+                !entry.value("block_hash", nlohmann::json()).is_string() || !entry.value("block_height", nlohmann::json()).is_number_unsigned())
+            {
+                continue;
+            }
+            access_keys.emplace(it.key(), CachedAccessKey{entry["permission"], entry["nonce"], entry["block_hash"], entry["block_height"]});
+        }
+        return access_keys;
+    }
+
+    bool AccessKeyCache::store(const std::string &network, const std::string &account_id, const std::map<std::string, CachedAccessKey> &access_keys) const
+    {
+        std::lock_guard lock(cache_files_mutex);
+        nlohmann::json content = read_cache_file(m_path);
+        nlohmann::json &network_entries = content[network];
+        if (!network_entries.is_object())
+        {
+            network_entries = nlohmann::json::object();
+        }
+        nlohmann::json &account = network_entries[account_id];
+        if (!account.is_object())
+        {
+            account = nlohmann::json::object();
+        }
+        for (const auto &[public_key, access_key] : access_keys)
+        {
+            account[public_key] = {
+                {"permission", access_key.permission},
+                {"nonce", access_key.nonce},
+                {"block_hash", access_key.block_hash},
+                {"block_height", access_key.block_height}};
+        }
+
+        // Written next to the file then renamed over it, readers never see a partial file
+        const std::string temporary_path = m_path + ".tmp";
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            if (!(file << content.dump(2)))
+            {
+                return false;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(temporary_path, m_path, error);
+        return !error;
+    }
+
+    const std::string &AccessKeyCache::path() const
+    {
+        return m_path;
+    }
+}
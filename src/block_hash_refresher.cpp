@@ -0,0 +1,132 @@
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include <base58/base58.hpp>
+
+#include <ntb/block_hash_refresher.hpp>
+
+namespace ntb
+{
+    BlockHashRefresher::BlockHashRefresher(RPCClient &rpc, const BlockHashRefresherOptions &options)
+        : m_rpc(rpc), m_options(options), m_next_refresh(std::chrono::steady_clock::now() + options.interval)
+    {
+        m_thread = std::thread(&BlockHashRefresher::_run, this);
+    }
+
+    BlockHashRefresher::~BlockHashRefresher()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wakeup.notify_all();
+        m_thread.join();
+    }
+
+    void BlockHashRefresher::_run()
+    {
+        std::unique_lock lock(m_mutex);
+        while (!m_stopping)
+        {
+            if (!m_refresh_requested && std::chrono::steady_clock::now() < m_next_refresh)
+            {
+                m_wakeup.wait_until(lock, m_next_refresh);
+                continue;
+            }
+            m_refresh_requested = false;
+            lock.unlock();
+            try
+            {
+                refresh_now();
+            }
+            catch (const std::exception &)
+            {
+                std::lock_guard retry_lock(m_mutex);
+                m_next_refresh = std::chrono::steady_clock::now() + m_options.retry_interval;
+            }
+            lock.lock();
+        }
+    }
+
+    void BlockHashRefresher::_fetch()
+    {
+        const nlohmann::json block = m_rpc.call("block", {{"finality", "final"}}).expect("failed to get the latest final block").data;
+        const std::string block_hash_b58 = block["header"]["hash"];
+        std::array<uint8_t, 32> block_hash;
+        if (!base58::decode_32(block_hash_b58, block_hash.data()))
+        {
+            throw std::runtime_error(fmt::format("Could not decode block hash '{}'", block_hash_b58));
+        }
+        const uint64_t block_height = block["header"]["height"];
+
+        std::lock_guard lock(m_mutex);
+        if (!m_has_block_hash || block_height >= m_block_height)
+        {
+            m_block_hash = block_hash;
+            m_block_height = block_height;
+            m_has_block_hash = true;
+        }
+        m_generation++;
+        m_next_refresh = std::chrono::steady_clock::now() + m_options.interval;
+    }
+
+    std::array<uint8_t, 32> BlockHashRefresher::block_hash()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_has_block_hash)
+            {
+                return m_block_hash;
+            }
+        }
+        refresh_now();
+        std::lock_guard lock(m_mutex);
+        return m_block_hash;
+    }
+
+    void BlockHashRefresher::seed(const std::array<uint8_t, 32> &block_hash, uint64_t block_height)
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_has_block_hash || block_height > m_block_height)
+        {
+            m_block_hash = block_hash;
+            m_block_height = block_height;
+            m_has_block_hash = true;
+        }
+    }
+
+    void BlockHashRefresher::refresh_now()
+    {
+        uint64_t generation;
+        {
+            std::lock_guard lock(m_mutex);
+            generation = m_generation;
+        }
+        std::lock_guard refresh_lock(m_refresh_mutex);
+        {
+            // Another caller fetched while this one waited for its turn
+            std::lock_guard lock(m_mutex);
+            if (m_generation != generation)
+            {
+                return;
+            }
+        }
+        _fetch();
+    }
+
+    void BlockHashRefresher::request_refresh()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_refresh_requested = true;
+        }
+        m_wakeup.notify_all();
+    }
+
+    uint64_t BlockHashRefresher::block_height() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_block_height;
+    }
+}
@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include <ntb/connection_pool.hpp>
+
+namespace ntb
+{
+    ConnectionPool::Lease::Lease(ConnectionPool &pool, httplib::Client &client)
+        : m_pool(&pool), m_client(&client)
+    {
+    }
+
+    ConnectionPool::Lease::Lease(Lease &&other) noexcept
+        : m_pool(other.m_pool), m_client(other.m_client)
+    {
+        other.m_pool = nullptr;
+        other.m_client = nullptr;
+    }
+
+    ConnectionPool::Lease::~Lease()
+    {
+        if (m_pool)
+        {
+            m_pool->_release(m_client);
+        }
+    }
+
+    httplib::Client &ConnectionPool::Lease::operator*() const
+    {
+        return *m_client;
+    }
+
+    httplib::Client *ConnectionPool::Lease::operator->() const
+    {
+        return m_client;
+    }
+
+    ConnectionPool::ConnectionPool(const std::string &endpoint, const ConnectionPoolOptions &options)
+        : m_endpoint(endpoint)
+    {
+        const std::size_t pool_size = std::max<std::size_t>(options.size, 1);
+        m_connections.reserve(pool_size);
+        m_idle.reserve(pool_size);
+        for (std::size_t i = 0; i < pool_size; i++)
+        {
+            auto client = std::make_unique<httplib::Client>(endpoint);
+            client->set_keep_alive(options.keep_alive);
+            client->set_tcp_nodelay(true);
+            client->set_connection_timeout(options.connection_timeout_sec);
+            client->set_read_timeout(options.read_timeout_sec);
+            m_idle.push_back(client.get());
+            m_connections.push_back(std::move(client));
+        }
+    }
+
+    ConnectionPool::Lease ConnectionPool::acquire()
+    {
+        std::unique_lock lock(m_mutex);
+        m_available.wait(lock, [this]()
+                         { return !m_idle.empty(); });
+        httplib::Client *client = m_idle.back();
+        m_idle.pop_back();
+        return Lease(*this, *client);
+    }
+
+    std::optional<ConnectionPool::Lease> ConnectionPool::try_acquire()
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_idle.empty())
+        {
+            return std::nullopt;
+        }
+        httplib::Client *client = m_idle.back();
+        m_idle.pop_back();
+        return Lease(*this, *client);
+    }
+
+    void ConnectionPool::_release(httplib::Client *client)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_idle.push_back(client);
+        }
+        m_available.notify_one();
+    }
+
+    const std::string &ConnectionPool::endpoint() const
+    {
+        return m_endpoint;
+    }
+
+    std::size_t ConnectionPool::size() const
+    {
+        return m_connections.size();
+    }
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include <ntb/endpoint_set.hpp>
+
+namespace ntb
+{
+    EndpointSet::EndpointSet(const std::vector<std::string> &endpoints, const ConnectionPoolOptions &connections, const EndpointHealthOptions &options)
+        : m_options(options), m_endpoints(endpoints.size())
+    {
+        if (endpoints.empty())
+        {
+            throw std::invalid_argument("EndpointSet needs at least one endpoint");
+        }
+        m_options.smoothing = std::clamp(m_options.smoothing, 0.01, 1.0);
+        m_options.failure_threshold = std::max<uint32_t>(m_options.failure_threshold, 1);
+        for (std::size_t i = 0; i < endpoints.size(); i++)
+        {
+            m_endpoints[i].pool = std::make_unique<ConnectionPool>(endpoints[i], connections);
+        }
+    }
+
+    std::size_t EndpointSet::select(const std::vector<bool> &tried)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        std::lock_guard lock(m_mutex);
+
+        std::size_t best = m_endpoints.size();
+        double best_score = std::numeric_limits<double>::infinity();
+        std::size_t fallback = m_endpoints.size();
+        for (std::size_t i = 0; i < m_endpoints.size(); i++)
+        {
+            const Endpoint &endpoint = m_endpoints[i];
+            if (tried[i])
+            {
+                continue;
+            }
+            if (endpoint.ejected && (endpoint.probing || now < endpoint.ejected_until))
+            {
+                // Only used when every endpoint left is ejected, the one coming back first is the best guess
+                if (fallback == m_endpoints.size() || endpoint.ejected_until < m_endpoints[fallback].ejected_until)
+                {
+                    fallback = i;
+                }
+                continue;
+            }
+            // Endpoints without samples score 0 so they get measured, failures make the rest look proportionally slower
+            const double score = endpoint.latency_us / std::max(1.0 - endpoint.error_rate, 0.05);
+            if (score < best_score)
+            {
+                best = i;
+                best_score = score;
+            }
+        }
+
+        if (best == m_endpoints.size())
+        {
+            best = fallback;
+        }
+        if (best == m_endpoints.size())
+        {
+            throw std::logic_error("EndpointSet::select called with every endpoint tried");
+        }
+        if (m_endpoints[best].ejected)
+        {
+            m_endpoints[best].probing = true;
+        }
+        return best;
+    }
+
+    void EndpointSet::report(std::size_t index, std::chrono::steady_clock::duration latency, bool success)
+    {
+        std::lock_guard lock(m_mutex);
+        Endpoint &endpoint = m_endpoints.at(index);
+        const double smoothing = m_options.smoothing;
+        endpoint.requests++;
+        endpoint.probing = false;
+        endpoint.error_rate = (1.0 - smoothing) * endpoint.error_rate + (success ? 0.0 : smoothing);
+
+        if (success)
+        {
+            const double sample_us = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+            endpoint.latency_us = (endpoint.requests == endpoint.failures + 1) ? sample_us : (1.0 - smoothing) * endpoint.latency_us + smoothing * sample_us;
+            endpoint.consecutive_failures = 0;
+            endpoint.ejected = false;
+            return;
+        }
+
+        endpoint.failures++;
+        endpoint.consecutive_failures++;
+        // A failed probe ejects again right away
+        if (endpoint.ejected || endpoint.consecutive_failures >= m_options.failure_threshold)
+        {
+            endpoint.ejected = true;
+            endpoint.ejected_until = std::chrono::steady_clock::now() + m_options.ejection_time;
+        }
+    }
+
+    void EndpointSet::abandon(std::size_t index)
+    {
+        std::lock_guard lock(m_mutex);
+        m_endpoints.at(index).probing = false;
+    }
+
+    ConnectionPool &EndpointSet::pool(std::size_t index) const
+    {
+        return *m_endpoints.at(index).pool;
+    }
+
+    std::size_t EndpointSet::size() const
+    {
+        return m_endpoints.size();
+    }
+
+    std::size_t EndpointSet::connections_count() const
+    {
+        std::size_t count = 0;
+        for (const Endpoint &endpoint : m_endpoints)
+        {
+            count += endpoint.pool->size();
+        }
+        return count;
+    }
+
+    std::vector<EndpointStats> EndpointSet::stats() const
+    {
+        std::lock_guard lock(m_mutex);
+        std::vector<EndpointStats> stats;
+        stats.reserve(m_endpoints.size());
+        for (const Endpoint &endpoint : m_endpoints)
+        {
+            stats.push_back(EndpointStats{
+                endpoint.pool->endpoint(),
+                std::chrono::microseconds(static_cast<int64_t>(endpoint.latency_us)),
+                endpoint.error_rate,
+                endpoint.requests,
+                endpoint.failures,
+                endpoint.ejected});
+        }
+        return stats;
+    }
+}
@@ -1,3 +1,6 @@
+#include <iomanip>
+#include <sstream>
+
 #include <fmt/format.h>
 #include <magic_enum/magic_enum.hpp>
 
@@ -8,33 +11,190 @@
 #include "borsh/borsh.hpp"
 #include "ed25519/ed25519.h"
 #include "ntb/near_utils.hpp"
-#include "sha256/sha256.hpp"
+#include "ntb/view_result.hpp"
 
 namespace ntb
 {
-    NearAmount::operator BigNumber() const
+    namespace
     {
-        return m_amount;
-    }
+        constexpr uint32_t MAX_BROADCAST_RETRIES = 3;
+        constexpr std::size_t MAX_ACTIONS_PER_TRANSACTION = 100;
 
-    NearAmount::NearAmount(int amount) : NearAmount(std::to_string(amount))
-    {
+        bool json_contains_key(const nlohmann::json &json, std::string_view key)
+        {
+            if (json.is_object())
+            {
+                for (auto it = json.begin(); it != json.end(); ++it)
+                {
+                    if (it.key() == key || json_contains_key(it.value(), key))
+                    {
+                        return true;
+                    }
+                }
+            }
+            else if (json.is_array())
+            {
+                return std::any_of(json.begin(), json.end(), [key](const nlohmann::json &value)
+                                   { return json_contains_key(value, key); });
+            }
+            return false;
+        }
+
+        nlohmann::json view_query_parameters(const std::string &contract_address, const std::string &method_name, RawArgs args)
+        {
+            return {
+                {"request_type", "call_function"},
+                {"finality", "final"},
+                {"account_id", contract_address},
+                {"method_name", method_name},
+                {"args_base64", base64::encode(args.data(), args.size())}};
+        }
+
+        bool json_contains_string(const nlohmann::json &json, std::string_view value)
+        {
+            if (json.is_string())
+            {
+                return json.get_ref<const std::string &>() == value;
+            }
+            if (json.is_object() || json.is_array())
+            {
+                return std::any_of(json.begin(), json.end(), [value](const nlohmann::json &element)
+                                   { return json_contains_string(element, value); });
+            }
+            return false;
+        }
+
+        bool is_invalid_nonce_error(const RPCError &error)
+        {
+            return json_contains_key(error.data, "InvalidNonce");
+        }
+
+        // InvalidTxError::InvalidAccessKeyError, such as AccessKeyNotFound when the key was deleted
+        bool is_invalid_access_key_error(const RPCError &error)
+        {
+            return json_contains_key(error.data, "InvalidAccessKeyError");
+        }
+
+        // InvalidTxError::Expired, the transaction was signed with a block hash that is too old
+        bool is_expired_error(const RPCError &error)
+        {
+            return json_contains_string(error.data, "Expired") || json_contains_key(error.data, "Expired");
+        }
     }
 
-    NearAmount::NearAmount(long long amount) : NearAmount(std::to_string(amount))
+    NearClient::NearClient(const std::string_view network, std::vector<std::unique_ptr<Signer>> signers, const AccountId &account_id,
+                           const NearClientOptions &options)
+        : m_network(network), m_rpc(options.rpc_endpoints.empty() ? std::vector<std::string>{_get_rpc_endpoint(m_network)} : options.rpc_endpoints, options.rpc),
+          m_block_hashes(m_rpc, options.block_hash), m_tracker(m_rpc, options.tracker)
     {
+        if (signers.empty())
+        {
+            throw std::runtime_error("NearClient requires at least one signer");
+        }
+        for (auto &signer : signers)
+        {
+            _add_key(std::move(signer));
+        }
+        _resolve_account_id(account_id);
+        for (auto &key : m_keys)
+        {
+            key->nonces = NonceManager::for_access_key(m_account_id, key->public_key_b58);
+        }
+        if (!options.access_key_cache_path.empty())
+        {
+            m_access_key_cache.emplace(options.access_key_cache_path);
+        }
+
+        if (options.startup == NearClientStartup::Blocking)
+        {
+            _start();
+        }
+        else if (options.startup == NearClientStartup::Background)
+        {
+            m_background_startup = std::async(std::launch::async, [this]()
+                                              { _start(); })
+                                       .share();
+        }
     }
 
-    NearAmount::NearAmount(double amount) : NearAmount(std::to_string(amount))
+    NearClient::~NearClient()
     {
+        if (m_background_startup.valid())
+        {
+            m_background_startup.wait();
+        }
+        if (!m_started || !m_access_key_cache)
+        {
+            return;
+        }
+        std::vector<KeySlot *> keys;
+        {
+            std::lock_guard lock(m_keys_mutex);
+            for (auto &key : m_keys)
+            {
+                keys.push_back(key.get());
+            }
+        }
+        try
+        {
+            _store_access_keys(keys);
+        }
+        catch (...)
+        {
+            // The cache is only a hint, failing to update it must not escape a destructor
+        }
     }
 
-    NearAmount::NearAmount(const std::string &amount) : m_amount(ntb::parse_near_amount(amount).value_or("0"))
+    void NearClient::wait_started()
     {
+        if (m_started)
+        {
+            return;
+        }
+        if (m_background_startup.valid())
+        {
+            m_background_startup.get();
+            return;
+        }
+        _start();
     }
 
-    NearAmount::NearAmount(const char *amount) : NearAmount(std::string(amount))
+    void NearClient::_start()
     {
+        std::lock_guard lock(m_startup_mutex);
+        if (m_started)
+        {
+            return;
+        }
+
+        std::vector<KeySlot *> missing_keys;
+        bool any_from_cache = false;
+        {
+            const auto cached_access_keys = m_access_key_cache ? m_access_key_cache->load(m_network, m_account_id)
+                                                               : std::map<std::string, CachedAccessKey>{};
+            std::lock_guard keys_lock(m_keys_mutex);
+            for (auto &key : m_keys)
+            {
+                const auto cached = cached_access_keys.find(key->public_key_b58);
+                if (cached == cached_access_keys.end())
+                {
+                    missing_keys.push_back(key.get());
+                    continue;
+                }
+                _apply_access_key(*key, cached->second, true);
+                any_from_cache = true;
+            }
+        }
+        if (!missing_keys.empty())
+        {
+            _load_access_keys(missing_keys);
+        }
+        // The cached block hash is most likely too old to sign with, fetch a fresh one without waiting for it
+        if (any_from_cache)
+        {
+            m_block_hashes.request_refresh();
+        }
+        m_started = true;
     }
 
     std::string NearClient::_get_rpc_endpoint(const std::string &network)
@@ -42,27 +202,69 @@ namespace ntb
         return fmt::format("http://rpc.{}.near.org", network);
     }
 
-    void NearClient::_load_access_key()
+    void NearClient::_load_access_keys(const std::vector<KeySlot *> &keys, const std::string &finality)
     {
         // Retrieving AccessKey details
-        const nlohmann::json access_key_query_parameters = {
-            {"request_type", "view_access_key"},
-            {"finality", "final"},
-            {"account_id", m_account_id},
-            {"public_key", fmt::format("ed25519:{}", m_signer->get_public_key_as_b58())}};
+        std::vector<nlohmann::json> access_key_queries_parameters;
+        access_key_queries_parameters.reserve(keys.size());
+        for (const KeySlot *key : keys)
+        {
+            access_key_queries_parameters.push_back({
+                {"request_type", "view_access_key"},
+                {"finality", finality},
+                {"account_id", m_account_id},
+                {"public_key", fmt::format("ed25519:{}", key->public_key_b58)}});
+        }
+        auto access_key_resps = (keys.size() == 1)
+            ? std::vector<RPCResponse>{m_rpc.query(access_key_queries_parameters.front())}
+            : m_rpc.query_batch(access_key_queries_parameters);
 
-        auto access_key_resp = m_rpc.query(access_key_query_parameters);
-        auto access_key_result = access_key_resp.expect("failed to get AccessKey details").data;
+        for (std::size_t key_index = 0; key_index < keys.size(); key_index++)
+        {
+            auto access_key_result = access_key_resps[key_index].expect("failed to get AccessKey details").data;
+            _apply_access_key(*keys[key_index],
+                              CachedAccessKey{access_key_result["permission"], access_key_result["nonce"], access_key_result["block_hash"], access_key_result["block_height"]},
+                              false);
+        }
+        if (m_access_key_cache)
+        {
+            _store_access_keys(keys);
+        }
+    }
 
-        std::cout << "PublicKey " << m_signer->get_public_key_as_b58() << std::endl;
-        std::cout << "AccessKey " << access_key_result.dump() << std::endl;
+    void NearClient::_apply_access_key(KeySlot &key, const CachedAccessKey &access_key, bool from_cache)
+    {
+        std::array<uint8_t, 32> block_hash = {};
+        if (!base58::decode_32(access_key.block_hash, block_hash.data()))
+        {
+            throw std::runtime_error(fmt::format("Could not decode recent block hash '{}'", access_key.block_hash));
+        }
+        {
+            std::lock_guard lock(key.access_key_mutex);
+            key.access_key = AccessKey{
+                magic_enum::enum_cast<AccessKeyPermission>(access_key.permission).value_or(AccessKeyPermission::None),
+                access_key.nonce,
+                access_key.block_hash};
+            key.from_cache = from_cache;
+        }
+        key.nonces->sync(access_key.nonce);
+        m_block_hashes.seed(block_hash, access_key.block_height);
+    }
 
-        const std::string permission_level = access_key_result["permission"];
-        const uint64_t nonce = access_key_result["nonce"];
-        m_access_key = AccessKey{
-            magic_enum::enum_cast<AccessKeyPermission>(permission_level).value_or(AccessKeyPermission::None),
-            nonce,
-            access_key_result["block_hash"]};
+    void NearClient::_store_access_keys(const std::vector<KeySlot *> &keys)
+    {
+        const uint64_t block_height = m_block_hashes.block_height();
+        const std::string block_hash = base58::encode_32(m_block_hashes.block_hash().data());
+        std::map<std::string, CachedAccessKey> access_keys;
+        for (const KeySlot *key : keys)
+        {
+            std::lock_guard lock(key->access_key_mutex);
+            const std::string_view permission = magic_enum::enum_name(key->access_key.permission);
+            // Nonces handed out since the access key was loaded are consumed on chain, or will be
+            const uint64_t nonce = std::max(key->access_key.nonce, key->nonces->last_nonce());
+            access_keys.emplace(key->public_key_b58, CachedAccessKey{std::string(permission), nonce, block_hash, block_height});
+        }
+        m_access_key_cache->store(m_network, m_account_id, access_keys);
     }
 
     std::string NearClient::account_id_from_public_key(const std::array<uint8_t, 32> &public_key)
@@ -83,9 +285,10 @@ namespace ntb
         return ""; // TODO
     }
 
-    void NearClient::_assert_access_key_sufficient_permissions(AccessKeyPermission minimum_permission)
+    void NearClient::_assert_access_key_sufficient_permissions(const KeySlot &key, AccessKeyPermission minimum_permission)
     {
-        const bool sufficient_permission = static_cast<uint8_t>(m_access_key.permission) >= static_cast<uint8_t>(minimum_permission);
+        std::lock_guard lock(key.access_key_mutex);
+        const bool sufficient_permission = static_cast<uint8_t>(key.access_key.permission) >= static_cast<uint8_t>(minimum_permission);
         if (!sufficient_permission)
         {
             throw std::runtime_error("AccessKey has unsufficient permission");
@@ -94,9 +297,10 @@ namespace ntb
 
     void NearClient::_resolve_account_id(AccountId account_id)
     {
+        const std::array<uint8_t, 32> &public_key = m_keys.front()->public_key;
         if (std::holds_alternative<ImplicitAccount>(account_id))
         {
-            m_account_id = NearClient::account_id_from_public_key(m_signer->get_public_key());
+            m_account_id = NearClient::account_id_from_public_key(public_key);
         }
         else if (std::holds_alternative<NamedAccount>(account_id))
         {
@@ -105,72 +309,273 @@ namespace ntb
         else if (std::holds_alternative<AccountIdResolver>(account_id))
         {
             const std::string resolver_url = std::get<AccountIdResolver>(account_id).resolver_url;
-            m_account_id = account_id_from_online_resolver(resolver_url, m_signer->get_public_key());
+            m_account_id = account_id_from_online_resolver(resolver_url, public_key);
         }
     }
 
-    TransactionResult NearClient::transaction(const std::string &recipient, const std::vector<schemas::Action> &actions)
+    NearClient::KeySlot &NearClient::_add_key(std::unique_ptr<Signer> signer)
     {
-        _assert_access_key_sufficient_permissions(AccessKeyPermission::FullAccess);
-
-        uint64_t nonce = m_access_key.nonce;
-        nonce++;
+        return _add_key(_make_key(std::move(signer)));
+    }
 
-        // Retrieving recent block hash
-        std::string block_hash_b58 = m_access_key.block_hash;
-        std::array<uint8_t, 32> recent_block_hash = {};
-        if (!base58::decode(block_hash_b58, recent_block_hash.data()))
+    std::unique_ptr<NearClient::KeySlot> NearClient::_make_key(std::unique_ptr<Signer> signer) const
+    {
+        auto key = std::make_unique<KeySlot>();
+        key->public_key = signer->get_public_key();
+        key->public_key_b58 = signer->get_public_key_as_b58();
+        key->signer = std::move(signer);
+        if (!m_account_id.empty())
         {
-            throw std::runtime_error(fmt::format("Could not decode recent block hash '{}'", block_hash_b58));
+            key->nonces = NonceManager::for_access_key(m_account_id, key->public_key_b58);
         }
+        return key;
+    }
 
-        // Building Transaction struct
-        ntb::schemas::Transaction transaction{
-            m_account_id,
-            ntb::schemas::ED25519PublicKey{m_signer->get_public_key()},
-            nonce,
-            recipient,
-            recent_block_hash,
-            actions,
-        };
+    NearClient::KeySlot &NearClient::_add_key(std::unique_ptr<KeySlot> key)
+    {
+        std::lock_guard lock(m_keys_mutex);
+        m_keys.push_back(std::move(key));
+        return *m_keys.back();
+    }
 
-        // Encoding Transaction using Borsh
-        BorshEncoder tx_encoder;
-        tx_encoder.Encode(transaction);
-        std::vector<uint8_t> tx_bytes = tx_encoder.GetBuffer();
-        std::cout << "TX PAYLOAD [";
-        for (uint8_t byte : tx_bytes)
+    NearClient::KeySlot &NearClient::_select_key()
+    {
+        std::lock_guard lock(m_keys_mutex);
+        KeySlot *least_loaded_key = m_keys.front().get();
+        std::size_t least_load = least_loaded_key->nonces->in_flight();
+        for (std::size_t key_index = 1; key_index < m_keys.size() && least_load > 0; key_index++)
         {
-            std::cout << static_cast<int>(byte) << ", ";
+            const std::size_t load = m_keys[key_index]->nonces->in_flight();
+            if (load < least_load)
+            {
+                least_loaded_key = m_keys[key_index].get();
+                least_load = load;
+            }
         }
-        std::cout << "]" << std::endl;
+        return *least_loaded_key;
+    }
+
+    TransactionBuilder &NearClient::_build_transaction(const KeySlot &key, const std::string &recipient,
+                                                       const std::vector<schemas::Action> &actions, uint64_t nonce)
+    {
+        _assert_access_key_sufficient_permissions(key, AccessKeyPermission::FullAccess);
+
+        TransactionBuilder &builder = TransactionBuilder::for_current_thread();
+        builder.build(*key.signer, m_account_id, key.public_key, nonce, recipient, _recent_block_hash(), actions);
+        return builder;
+    }
 
-        // Building Transaction signature
-        sha256::SHA256 tx_hasher;
-        tx_hasher.update(tx_bytes.data(), tx_bytes.size());
-        sha256::hash_container tx_hash = tx_hasher.digest();
-        std::vector<uint8_t> msg_to_sign = std::vector<uint8_t>(tx_hash.begin(), tx_hash.end());
-        std::array<uint8_t, 64> signature = m_signer->sign(msg_to_sign);
+    std::array<uint8_t, 32> NearClient::_recent_block_hash()
+    {
+        return m_block_hashes.block_hash();
+    }
 
-        // Building SignedTransaction
-        ntb::schemas::SignedTransaction signed_transaction{transaction, ntb::schemas::Signature{ntb::schemas::KeyType::ED25519, signature}};
-        BorshEncoder signed_tx_encoder;
-        signed_tx_encoder.Encode(signed_transaction);
-        std::vector<uint8_t> signed_tx_bytes = signed_tx_encoder.GetBuffer();
+    NearClient::Broadcast NearClient::_broadcast(const std::string &method_name, const std::string &recipient,
+                                                 const std::vector<schemas::Action> &actions)
+    {
+        return _broadcast(method_name, [&](const KeySlot &key, uint64_t nonce) -> TransactionBuilder &
+                          { return _build_transaction(key, recipient, actions, nonce); });
+    }
 
-        // Broadcasting transaction
-        nlohmann::json broadcast_tx_parameters = {base64::encode(signed_tx_bytes.data(), signed_tx_bytes.size())};
-        auto broadcast_resp = m_rpc.call("broadcast_tx_commit", broadcast_tx_parameters);
-        if (broadcast_resp.has_error())
+    NearClient::Broadcast NearClient::_broadcast(const std::string &method_name,
+                                                 const std::function<TransactionBuilder &(const KeySlot &, uint64_t)> &build)
+    {
+        wait_started();
+        for (uint32_t attempt = 0;; attempt++)
         {
-            auto error = broadcast_resp.error();
-            throw std::runtime_error(error.data.dump());
+            KeySlot &key = _select_key();
+            if (key.reload_requested.exchange(false))
+            {
+                try
+                {
+                    _load_access_keys({&key});
+                }
+                catch (...)
+                {
+                    key.reload_requested = true;
+                    throw;
+                }
+            }
+            const uint64_t nonce = key.nonces->acquire();
+            std::array<uint8_t, 32> tx_hash;
+            RPCResponse broadcast_resp;
+            try
+            {
+                TransactionBuilder &builder = build(key, nonce);
+                tx_hash = builder.hash();
+                // Broadcasting transaction
+                broadcast_resp = m_rpc.call_serialized(builder.rpc_body(method_name));
+            }
+            catch (...)
+            {
+                key.nonces->release(nonce);
+                throw;
+            }
+            if (broadcast_resp.has_error())
+            {
+                key.nonces->release(nonce);
+                auto error = broadcast_resp.error();
+                const bool from_cache = [&key]()
+                {
+                    std::lock_guard lock(key.access_key_mutex);
+                    return key.from_cache;
+                }();
+                // Only errors proving the chain rejected the transaction allow signing a new one, others may still execute
+                if (attempt < MAX_BROADCAST_RETRIES && (is_invalid_nonce_error(error) || (from_cache && is_invalid_access_key_error(error))))
+                {
+                    _load_access_keys({&key});
+                    continue;
+                }
+                if (attempt < MAX_BROADCAST_RETRIES && is_expired_error(error))
+                {
+                    m_block_hashes.refresh_now();
+                    continue;
+                }
+                // A cached access key may have been deleted or had its nonce moved by another process, checked for the next sends
+                if (from_cache)
+                {
+                    try
+                    {
+                        _load_access_keys({&key});
+                    }
+                    catch (const std::exception &)
+                    {
+                        // The broadcast error is the one to report
+                    }
+                }
+                throw std::runtime_error(error.data.dump());
+            }
+            return Broadcast{&key, nonce, tx_hash, std::move(broadcast_resp.value().data)};
         }
-        auto broadcast_result = broadcast_resp.value().data; // TODO: better error handling
+    }
+
+    TransactionResult NearClient::transaction(const std::string &recipient, const std::vector<schemas::Action> &actions)
+    {
+        Broadcast broadcast = _broadcast("broadcast_tx_commit", recipient, actions);
+        broadcast.key->nonces->release(broadcast.nonce);
+        auto broadcast_result = std::move(broadcast.result); // TODO: better error handling
 
         return TransactionResult{broadcast_result};
     }
 
+    std::string NearClient::transaction_async(const std::string &recipient, const std::vector<schemas::Action> &actions)
+    {
+        const Broadcast broadcast = _broadcast("broadcast_tx_async", recipient, actions);
+        broadcast.key->nonces->release(broadcast.nonce);
+
+        // broadcast_tx_async answers with the transaction hash, which we already know
+        const auto &tx_hash = broadcast.tx_hash;
+        return base58::encode_32(tx_hash.data());
+    }
+
+    SubmittedTransaction NearClient::submit(const std::string &recipient, const std::vector<schemas::Action> &actions, TxFinality finality)
+    {
+        const Broadcast broadcast = _broadcast("broadcast_tx_async", recipient, actions);
+        const auto &tx_hash = broadcast.tx_hash;
+        std::string tx_hash_b58 = base58::encode_32(tx_hash.data());
+
+        // The nonce stays in flight until the outcome is known so the key scheduler sees the real load
+        auto outcome = std::make_shared<std::promise<RPCResponse>>();
+        std::future<RPCResponse> future = outcome->get_future();
+        KeySlot *key = broadcast.key;
+        const uint64_t nonce = broadcast.nonce;
+        m_tracker.track(tx_hash_b58, m_account_id, finality, [this, outcome, key, nonce](RPCResponse response)
+                        {
+            key->nonces->release(nonce);
+            // The rejection only surfaces once the transaction is processed, the next send on this key reloads the chain nonce.
+            // Runs on the tracker thread, which must not make blocking queries that could throw
+            if (response.has_error() && is_invalid_nonce_error(response.error()))
+            {
+                key->reload_requested = true;
+            }
+            if (response.has_error() && is_expired_error(response.error()))
+            {
+                m_block_hashes.request_refresh();
+            }
+            outcome->set_value(std::move(response)); });
+        return SubmittedTransaction{std::move(tx_hash_b58), std::move(future)};
+    }
+
+    void NearClient::add_signer(std::unique_ptr<Signer> signer)
+    {
+        wait_started();
+        std::unique_ptr<KeySlot> key = _make_key(std::move(signer));
+        _load_access_keys({key.get()});
+        _add_key(std::move(key));
+    }
+
+    std::vector<ED25519Keypair> NearClient::provision_access_keys(std::size_t count)
+    {
+        wait_started();
+        std::vector<ED25519Keypair> keypairs;
+        keypairs.reserve(count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            keypairs.push_back(ED25519Keypair::create());
+        }
+
+        for (std::size_t begin = 0; begin < count; begin += MAX_ACTIONS_PER_TRANSACTION)
+        {
+            const std::size_t end = std::min(begin + MAX_ACTIONS_PER_TRANSACTION, count);
+            std::vector<schemas::Action> actions;
+            actions.reserve(end - begin);
+            for (std::size_t key_index = begin; key_index < end; key_index++)
+            {
+                actions.push_back(schemas::AddKey{
+                    schemas::ED25519PublicKey{keypairs[key_index].get_public_key()},
+                    schemas::AccessKey{0, schemas::FullAccessPermission{}}});
+            }
+            const TransactionResult result = transaction(m_account_id, actions);
+            const auto status = result.tx_data.find("status");
+            if (status != result.tx_data.end() && status->is_object() && status->contains("Failure"))
+            {
+                throw std::runtime_error(fmt::format("failed to add access keys: {}", (*status)["Failure"].dump()));
+            }
+
+            // Keys of the chunks already added stay usable if a later chunk fails
+            std::vector<std::unique_ptr<KeySlot>> new_keys;
+            std::vector<KeySlot *> keys;
+            new_keys.reserve(end - begin);
+            keys.reserve(end - begin);
+            for (std::size_t key_index = begin; key_index < end; key_index++)
+            {
+                new_keys.push_back(_make_key(std::make_unique<ED25519Keypair>(keypairs[key_index])));
+                keys.push_back(new_keys.back().get());
+            }
+            // broadcast_tx_commit returns once the keys are added in an optimistic block, which final views do not see yet
+            _load_access_keys(keys, "optimistic");
+            for (auto &key : new_keys)
+            {
+                _add_key(std::move(key));
+            }
+        }
+
+        return keypairs;
+    }
+
+    std::size_t NearClient::signers_count() const
+    {
+        std::lock_guard lock(m_keys_mutex);
+        return m_keys.size();
+    }
+
+    TransactionTracker &NearClient::tracker()
+    {
+        return m_tracker;
+    }
+
+    RPCClient &NearClient::rpc()
+    {
+        return m_rpc;
+    }
+
+    NonceManager &NearClient::nonces(std::size_t key_index)
+    {
+        wait_started();
+        std::lock_guard lock(m_keys_mutex);
+        return *m_keys.at(key_index)->nonces;
+    }
+
     TransactionResult NearClient::transfer(const std::string &recipient, const NearAmount &amount)
     {
         return transaction(recipient, {ntb::schemas::Transfer{amount}});
@@ -181,27 +586,108 @@ namespace ntb
     ContractCallResult NearClient::contract_call(const std::string &contract_address, const std::string &method_name,
                                                  const nlohmann::json &parameters, const NearAmount &deposit)
     {
-        const std::string parameters_b64 = parameters.dump();
-        const std::vector<uint8_t> parameters_bytes(parameters_b64.cbegin(), parameters_b64.cend());
-        const std::vector<schemas::Action> actions = {schemas::FunctionCall{method_name, parameters_bytes, MAX_GAS, deposit}};
+        const std::string parameters_json = parameters.dump();
+        return contract_call(contract_address, method_name, RawArgs(parameters_json), deposit);
+    }
+
+    ContractCallResult NearClient::contract_call(const std::string &contract_address, const std::string &method_name,
+                                                 RawArgs args, const NearAmount &deposit)
+    {
+        const std::vector<schemas::Action> actions = {schemas::FunctionCall{method_name, std::vector<uint8_t>(args.data(), args.data() + args.size()), MAX_GAS, deposit}};
         const auto tx_data = transaction(contract_address, actions);
         return ContractCallResult{tx_data, {}};
     }
 
+    TransactionTemplate NearClient::function_call_template(const std::string &contract_address, const std::string &method_name) const
+    {
+        return TransactionTemplate(m_account_id, contract_address, method_name);
+    }
+
+    ContractCallResult NearClient::contract_call(const TransactionTemplate &transaction_template, const nlohmann::json &parameters,
+                                                 const NearAmount &deposit)
+    {
+        const std::string parameters_json = parameters.dump();
+        return contract_call(transaction_template, RawArgs(parameters_json), deposit);
+    }
+
+    ContractCallResult NearClient::contract_call(const TransactionTemplate &transaction_template, RawArgs args, const NearAmount &deposit)
+    {
+        if (transaction_template.signer_id() != m_account_id)
+        {
+            throw std::runtime_error(fmt::format("TransactionTemplate signer '{}' is not the client account '{}'", transaction_template.signer_id(), m_account_id));
+        }
+        const uint128 deposit_yocto = deposit;
+        Broadcast broadcast = _broadcast("broadcast_tx_commit", [&](const KeySlot &key, uint64_t nonce) -> TransactionBuilder &
+                                         {
+            _assert_access_key_sufficient_permissions(key, AccessKeyPermission::FullAccess);
+            TransactionBuilder &builder = TransactionBuilder::for_current_thread();
+            transaction_template.build(builder, *key.signer, key.public_key, nonce, _recent_block_hash(),
+                                       args.data(), args.size(), MAX_GAS, deposit_yocto);
+            return builder; });
+        broadcast.key->nonces->release(broadcast.nonce);
+        return ContractCallResult{TransactionResult{std::move(broadcast.result)}, {}};
+    }
+
     ContractCallResult NearClient::contract_view(const std::string &contract_address, const std::string &method_name,
                                                  const nlohmann::json &parameters)
     {
-        const std::string call_parameters_b64 = base64::encode(parameters.dump());
-        const nlohmann::json query_parameters = {
-            {"request_type", "call_function"},
-            {"finality", "final"},
-            {"account_id", contract_address},
-            {"method_name", method_name},
-            {"args_base64", call_parameters_b64}};
-        auto query_resp = m_rpc.query(query_parameters);
+        const std::string parameters_json = parameters.dump();
+        return contract_view(contract_address, method_name, RawArgs(parameters_json));
+    }
+
+    ContractCallResult NearClient::contract_view(const std::string &contract_address, const std::string &method_name, RawArgs args)
+    {
+        auto query_resp = m_rpc.query(view_query_parameters(contract_address, method_name, args));
         auto tx_data = query_resp.expect("failed to query smart contract").data;
-        std::vector<uint8_t> call_result_bytes = tx_data["result"];
-        const std::string call_result_str = std::string(call_result_bytes.begin(), call_result_bytes.end());
-        return ContractCallResult{tx_data, nlohmann::json::parse(call_result_str)};
+        const std::vector<uint8_t> call_result_bytes = tx_data["result"].get<std::vector<uint8_t>>();
+        return ContractCallResult{tx_data, nlohmann::json::parse(call_result_bytes.begin(), call_result_bytes.end())};
+    }
+
+    std::vector<uint8_t> NearClient::_view_function(const std::string &contract_address, const std::string &method_name, RawArgs args)
+    {
+        const std::string body = m_rpc.query_unparsed(view_query_parameters(contract_address, method_name, args)).expect("failed to query smart contract");
+
+        std::vector<uint8_t> call_result_bytes;
+        if (scan_view_result(body, call_result_bytes))
+        {
+            return call_result_bytes;
+        }
+
+        // No result array, only then is the body parsed to report the RPC or contract error
+        const nlohmann::json response = nlohmann::json::parse(body, nullptr, false);
+        if (response.is_object() && response.contains("error"))
+        {
+            RPCResponse(cpp::fail(RPCError{response["error"]})).expect("failed to query smart contract");
+        }
+        if (response.is_object() && response.contains("result") && response["result"].contains("error"))
+        {
+            throw std::runtime_error(fmt::format("failed to query smart contract: {}", response["result"]["error"].dump()));
+        }
+        throw std::runtime_error(fmt::format("failed to query smart contract: unexpected response {}", body));
+    }
+
+    std::vector<uint8_t> NearClient::contract_view_raw(const std::string &contract_address, const std::string &method_name,
+                                                       const nlohmann::json &parameters)
+    {
+        const std::string parameters_json = parameters.dump();
+        return _view_function(contract_address, method_name, RawArgs(parameters_json));
+    }
+
+    std::vector<uint8_t> NearClient::contract_view_raw(const std::string &contract_address, const std::string &method_name, RawArgs args)
+    {
+        return _view_function(contract_address, method_name, args);
+    }
+
+    nlohmann::json NearClient::contract_view_json(const std::string &contract_address, const std::string &method_name,
+                                                  const nlohmann::json &parameters)
+    {
+        const std::string parameters_json = parameters.dump();
+        return contract_view_json(contract_address, method_name, RawArgs(parameters_json));
+    }
+
+    nlohmann::json NearClient::contract_view_json(const std::string &contract_address, const std::string &method_name, RawArgs args)
+    {
+        const std::vector<uint8_t> call_result_bytes = _view_function(contract_address, method_name, args);
+        return nlohmann::json::parse(call_result_bytes.begin(), call_result_bytes.end());
     }
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#include <fmt/format.h>
+
+#include <ntb/near_amount.hpp>
+
+namespace ntb
+{
+    namespace
+    {
+        NearAmount parse_or_throw(std::string_view amount)
+        {
+            const std::optional<NearAmount> near_amount = NearAmount::parse(amount);
+            if (!near_amount)
+            {
+                throw std::runtime_error(fmt::format("Cannot parse '{}' as NEAR amount", amount));
+            }
+            return *near_amount;
+        }
+    }
+
+    NearAmount::NearAmount(int amount) : NearAmount(static_cast<long long>(amount))
+    {
+    }
+
+    NearAmount::NearAmount(long long amount)
+    {
+        if (amount < 0)
+        {
+            throw std::runtime_error(fmt::format("Cannot use negative NEAR amount {}", amount));
+        }
+        *this = *this + from_yocto(uint128::pow10(NEAR_NOMINATION_EXP)) * static_cast<uint64_t>(amount);
+    }
+
+    NearAmount::NearAmount(double amount)
+    {
+        if (!std::isfinite(amount) || amount < 0)
+        {
+            throw std::runtime_error(fmt::format("Cannot use {} as NEAR amount", amount));
+        }
+        // Shortest round-trip decimal representation, so 0.1 stays 0.1 instead of 0.1000000000000000055...
+        char buffer[512];
+        const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), amount, std::chars_format::fixed);
+        if (error != std::errc())
+        {
+            throw std::runtime_error(fmt::format("Cannot use {} as NEAR amount", amount));
+        }
+        // Digits past yoctoNEAR are truncated, so tiny values such as 1e-30 become zero instead of failing to parse
+        std::string_view decimal(buffer, end - buffer);
+        const std::size_t dot = decimal.find('.');
+        if (dot != std::string_view::npos)
+        {
+            decimal = decimal.substr(0, dot + 1 + NEAR_NOMINATION_EXP);
+        }
+        *this = parse_or_throw(decimal);
+    }
+
+    NearAmount::NearAmount(const std::string &amount) : NearAmount(amount.c_str())
+    {
+    }
+
+    NearAmount::NearAmount(const char *amount)
+    {
+        const std::string_view amount_view(amount);
+        if (amount_view.find_first_not_of(" \t\r\n") != std::string_view::npos)
+        {
+            *this = parse_or_throw(amount_view);
+        }
+    }
+
+    NearAmount NearAmount::from_yocto(const std::string &amount)
+    {
+        const std::optional<NearAmount> near_amount = parse_yocto(amount);
+        if (!near_amount)
+        {
+            throw std::runtime_error(fmt::format("Cannot parse '{}' as yoctoNEAR amount", amount));
+        }
+        return *near_amount;
+    }
+
+    char *NearAmount::to_chars(char *first, char *last) const
+    {
+        // Left pad to 25 digits so there is always at least one whole digit before the dot
+        char digits[uint128::MAX_DECIMAL_DIGITS];
+        char *digits_end = m_yocto.to_chars(digits, digits + sizeof(digits));
+        std::size_t length = digits_end - digits;
+        constexpr std::size_t MIN_DIGITS = NEAR_NOMINATION_EXP + 1;
+        char padded[uint128::MAX_DECIMAL_DIGITS + NEAR_NOMINATION_EXP];
+        const std::size_t padding = length < MIN_DIGITS ? MIN_DIGITS - length : 0;
+        std::memset(padded, '0', padding);
+        std::memcpy(padded + padding, digits, length);
+        length += padding;
+
+        const std::size_t whole_length = length - NEAR_NOMINATION_EXP;
+        std::size_t fraction_length = NEAR_NOMINATION_EXP;
+        while (fraction_length > 0 && padded[whole_length + fraction_length - 1] == '0')
+        {
+            fraction_length--;
+        }
+
+        const std::size_t total_length = whole_length + (fraction_length > 0 ? fraction_length + 1 : 0);
+        if (static_cast<std::size_t>(last - first) < total_length)
+        {
+            return nullptr;
+        }
+        std::memcpy(first, padded, whole_length);
+        if (fraction_length > 0)
+        {
+            first[whole_length] = '.';
+            std::memcpy(first + whole_length + 1, padded + whole_length, fraction_length);
+        }
+        return first + total_length;
+    }
+
+    std::string NearAmount::to_string() const
+    {
+        char buffer[MAX_FORMATTED_SIZE];
+        const char *end = to_chars(buffer, buffer + sizeof(buffer));
+        return std::string(buffer, end - buffer);
+    }
+
+    NearAmount::operator BigNumber() const
+    {
+        return BigNumber(m_yocto.to_string());
+    }
+}
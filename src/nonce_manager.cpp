@@ -0,0 +1,74 @@
+#include <map>
+#include <utility>
+
+#include <ntb/nonce_manager.hpp>
+
+namespace ntb
+{
+    std::shared_ptr<NonceManager> NonceManager::for_access_key(const std::string &account_id, const std::string &public_key)
+    {
+        static std::mutex registry_mutex;
+        static std::map<std::pair<std::string, std::string>, std::weak_ptr<NonceManager>> registry;
+        static std::size_t pruned_size = 0;
+
+        std::lock_guard lock(registry_mutex);
+        // Entries of access keys no client uses anymore are dropped whenever the registry doubles in size
+        if (registry.size() >= 2 * pruned_size + 16)
+        {
+            for (auto it = registry.begin(); it != registry.end();)
+            {
+                it = it->second.expired() ? registry.erase(it) : std::next(it);
+            }
+            pruned_size = registry.size();
+        }
+        auto &entry = registry[{account_id, public_key}];
+        if (auto nonce_manager = entry.lock())
+        {
+            return nonce_manager;
+        }
+        auto nonce_manager = std::make_shared<NonceManager>();
+        entry = nonce_manager;
+        return nonce_manager;
+    }
+
+    uint64_t NonceManager::acquire()
+    {
+        std::lock_guard lock(m_mutex);
+        const uint64_t nonce = ++m_last_nonce;
+        m_in_flight.insert(nonce);
+        return nonce;
+    }
+
+    void NonceManager::release(uint64_t nonce)
+    {
+        std::lock_guard lock(m_mutex);
+        m_in_flight.erase(nonce);
+    }
+
+    void NonceManager::sync(uint64_t chain_nonce)
+    {
+        std::lock_guard lock(m_mutex);
+        if (chain_nonce > m_last_nonce)
+        {
+            m_last_nonce = chain_nonce;
+        }
+    }
+
+    uint64_t NonceManager::last_nonce() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_last_nonce;
+    }
+
+    std::size_t NonceManager::in_flight() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_in_flight.size();
+    }
+
+    bool NonceManager::is_in_flight(uint64_t nonce) const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_in_flight.count(nonce) > 0;
+    }
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+
+#include <ntb/request_hedger.hpp>
+
+namespace ntb
+{
+    RequestHedger::RequestHedger(const HedgingOptions &options)
+        : m_options(options), m_delay(options.delay.count() > 0 ? options.delay : options.initial_delay)
+    {
+        m_options.percentile = std::clamp(m_options.percentile, 0.0, 1.0);
+        m_latencies_us.reserve(LATENCY_WINDOW);
+        if (m_options.enabled)
+        {
+            m_thread = std::thread(&RequestHedger::_run, this);
+        }
+    }
+
+    RequestHedger::~RequestHedger()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wakeup.notify_all();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+        std::unique_lock lock(m_mutex);
+        m_tasks_done.wait(lock, [this]()
+                          { return m_running_tasks == 0; });
+    }
+
+    void RequestHedger::_run()
+    {
+        std::unique_lock lock(m_mutex);
+        while (!m_stopping)
+        {
+            if (m_timers.empty())
+            {
+                m_wakeup.wait(lock);
+                continue;
+            }
+            if (std::chrono::steady_clock::now() < m_timers.top().deadline)
+            {
+                m_wakeup.wait_until(lock, m_timers.top().deadline);
+                continue;
+            }
+            std::function<void()> callback = std::move(const_cast<Timer &>(m_timers.top()).callback);
+            m_timers.pop();
+            lock.unlock();
+            callback();
+            lock.lock();
+        }
+    }
+
+    bool RequestHedger::applies_to(std::string_view method_name) const
+    {
+        return m_options.enabled && std::find(m_options.methods.begin(), m_options.methods.end(), method_name) != m_options.methods.end();
+    }
+
+    std::chrono::microseconds RequestHedger::delay() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_delay;
+    }
+
+    void RequestHedger::record_latency(std::chrono::steady_clock::duration latency)
+    {
+        const int64_t latency_us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+        std::lock_guard lock(m_mutex);
+        if (m_latencies_us.size() < LATENCY_WINDOW)
+        {
+            m_latencies_us.push_back(latency_us);
+        }
+        else
+        {
+            m_latencies_us[m_next_latency] = latency_us;
+            m_next_latency = (m_next_latency + 1) % LATENCY_WINDOW;
+        }
+        if (++m_samples_since_update >= DELAY_UPDATE_INTERVAL)
+        {
+            _update_delay();
+        }
+    }
+
+    void RequestHedger::_update_delay()
+    {
+        m_samples_since_update = 0;
+        if (m_options.delay.count() > 0 || m_latencies_us.size() < MIN_LATENCY_SAMPLES)
+        {
+            return;
+        }
+        std::vector<int64_t> latencies = m_latencies_us;
+        const std::size_t rank = std::min(static_cast<std::size_t>(std::ceil(m_options.percentile * latencies.size())), latencies.size() - 1);
+        std::nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+        m_delay = std::max(std::chrono::microseconds(latencies[rank]), std::chrono::microseconds(m_options.min_delay));
+    }
+
+    void RequestHedger::schedule(std::chrono::steady_clock::time_point deadline, std::function<void()> callback)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_stopping)
+            {
+                return;
+            }
+            m_timers.push(Timer{deadline, std::move(callback)});
+        }
+        m_wakeup.notify_one();
+    }
+
+    void RequestHedger::launch(std::function<void()> task)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_running_tasks++;
+        }
+        std::thread([this, task = std::move(task)]() mutable
+                    {
+            task();
+            // Whatever the task holds (such as a connection lease) is released while the hedger still waits for it
+            task = nullptr;
+            std::lock_guard lock(m_mutex);
+            if (--m_running_tasks == 0)
+            {
+                m_tasks_done.notify_all();
+            } })
+            .detach();
+    }
+
+    void RequestHedger::count_request()
+    {
+        std::lock_guard lock(m_mutex);
+        m_stats.requests++;
+    }
+
+    void RequestHedger::count_hedge()
+    {
+        std::lock_guard lock(m_mutex);
+        m_stats.hedges++;
+    }
+
+    void RequestHedger::count_hedge_win()
+    {
+        std::lock_guard lock(m_mutex);
+        m_stats.hedge_wins++;
+    }
+
+    void RequestHedger::count_skipped()
+    {
+        std::lock_guard lock(m_mutex);
+        m_stats.skipped++;
+    }
+
+    HedgeStats RequestHedger::stats() const
+    {
+        std::lock_guard lock(m_mutex);
+        HedgeStats stats = m_stats;
+        stats.delay = m_delay;
+        return stats;
+    }
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+
+#include <ntb/response_cache.hpp>
+#include <ntb/view_result.hpp>
+
+namespace ntb
+{
+    ResponseCache::ResponseCache(const ResponseCacheOptions &options)
+        : m_options(options)
+    {
+    }
+
+    std::string ResponseCache::key(const nlohmann::json &parameters) const
+    {
+        if (m_options.capacity == 0 || !parameters.is_object())
+        {
+            return {};
+        }
+        const auto request_type = parameters.find("request_type");
+        if (request_type == parameters.end() || !request_type->is_string() ||
+            std::find(m_options.request_types.begin(), m_options.request_types.end(), request_type->get_ref<const std::string &>()) == m_options.request_types.end())
+        {
+            return {};
+        }
+        // Object keys are kept sorted, so equal parameters always dump the same way
+        return parameters.dump();
+    }
+
+    bool ResponseCache::_is_expired(const Entry &entry, std::chrono::steady_clock::time_point now) const
+    {
+        if (entry.finality.empty())
+        {
+            return false;
+        }
+        if (now - entry.stored_at > m_options.max_age)
+        {
+            return true;
+        }
+        const auto latest = m_latest_block_heights.find(entry.finality);
+        return latest != m_latest_block_heights.end() && latest->second > entry.block_height;
+    }
+
+    void ResponseCache::_erase(std::list<Entry>::iterator it)
+    {
+        m_index.erase(it->key);
+        m_entries.erase(it);
+    }
+
+    bool ResponseCache::get(const std::string &key, std::string &body)
+    {
+        std::lock_guard lock(m_mutex);
+        const auto it = m_index.find(key);
+        if (it == m_index.end())
+        {
+            m_stats.misses++;
+            return false;
+        }
+        if (_is_expired(*it->second, std::chrono::steady_clock::now()))
+        {
+            _erase(it->second);
+            m_stats.expired++;
+            m_stats.misses++;
+            return false;
+        }
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        body = it->second->body;
+        m_stats.hits++;
+        return true;
+    }
+
+    void ResponseCache::put(const std::string &key, const nlohmann::json &parameters, const std::string &body)
+    {
+        uint64_t block_height = 0;
+        if (key.empty() || !scan_query_block_height(body, block_height))
+        {
+            return;
+        }
+        std::string finality;
+        if (!parameters.contains("block_id"))
+        {
+            const auto finality_it = parameters.find("finality");
+            finality = (finality_it != parameters.end() && finality_it->is_string()) ? finality_it->get<std::string>() : "sync_checkpoint";
+        }
+
+        std::lock_guard lock(m_mutex);
+        if (!finality.empty())
+        {
+            uint64_t &latest = m_latest_block_heights[finality];
+            if (block_height < latest)
+            {
+                // Answered by a node lagging behind what was already seen
+                return;
+            }
+            latest = block_height;
+        }
+
+        const auto it = m_index.find(key);
+        if (it != m_index.end())
+        {
+            _erase(it->second);
+        }
+        m_entries.push_front(Entry{key, body, std::move(finality), block_height, std::chrono::steady_clock::now()});
+        m_index.emplace(m_entries.front().key, m_entries.begin());
+        if (m_entries.size() > m_options.capacity)
+        {
+            _erase(std::prev(m_entries.end()));
+        }
+    }
+
+    void ResponseCache::observe_block_height(std::string_view finality, uint64_t block_height)
+    {
+        std::lock_guard lock(m_mutex);
+        uint64_t &latest = m_latest_block_heights[std::string(finality)];
+        latest = std::max(latest, block_height);
+    }
+
+    void ResponseCache::clear()
+    {
+        std::lock_guard lock(m_mutex);
+        m_index.clear();
+        m_entries.clear();
+    }
+
+    ResponseCacheStats ResponseCache::stats() const
+    {
+        std::lock_guard lock(m_mutex);
+        ResponseCacheStats stats = m_stats;
+        stats.entries = m_entries.size();
+        return stats;
+    }
+}
@@ -1,55 +1,461 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 
 #include <ntb/rpc.hpp>
 
 namespace ntb
 {
-    RPCClient::RPCClient(const std::string &endpoint)
-        : m_endpoint(endpoint), m_client(endpoint)
+    RPCClient::RPCClient(const std::string &endpoint, const RPCClientOptions &options)
+        : RPCClient(std::vector<std::string>{endpoint}, options)
     {
     }
 
-    httplib::Result RPCClient::call_raw(const nlohmann::json &payload)
+    RPCClient::RPCClient(const std::vector<std::string> &endpoints, const RPCClientOptions &options)
+        : m_endpoints(endpoints, options.connections, options.health), m_max_batch_size(std::max<std::size_t>(options.max_batch_size, 1)), m_cache(options.cache),
+          m_single_flight(options.single_flight), m_hedger(options.hedging)
+    {
+    }
+
+    // Shared by the calling thread, which sends the first copy (slot 0), and the thread sending the hedge (slot 1)
+    struct RPCClient::HedgedRequest
+    {
+        std::string body;
+        std::vector<bool> tried;
+        std::size_t endpoint_indexes[2] = {};
+        std::mutex mutex;
+        std::condition_variable finished;
+        httplib::Client *clients[2] = {};
+        bool started[2] = {true, false};
+        bool completed[2] = {false, false};
+        std::optional<httplib::Result> results[2];
+        bool done = false;
+        std::size_t winner = 0;
+    };
+
+    bool RPCClient::_is_failure(const httplib::Result &resp)
+    {
+        return !resp || resp->status >= 500 || resp->status == 429;
+    }
+
+    httplib::Result RPCClient::_post(const std::string &body, bool idempotent)
+    {
+        std::vector<bool> tried(m_endpoints.size(), false);
+        while (true)
+        {
+            const std::size_t index = m_endpoints.select(tried);
+            tried[index] = true;
+            httplib::Result resp = (idempotent && m_endpoints.size() > 1) ? _send_hedged(index, body, tried) : _send(index, body);
+            if (!_is_failure(resp) || std::find(tried.begin(), tried.end(), false) == tried.end())
+            {
+                return resp;
+            }
+        }
+    }
+
+    httplib::Result RPCClient::_send(std::size_t endpoint_index, const std::string &body)
     {
-        auto resp = m_client.Post("/", payload.dump(), "application/json");
+        auto connection = m_endpoints.pool(endpoint_index).acquire();
+        const auto start = std::chrono::steady_clock::now();
+        httplib::Result resp = connection->Post("/", body, "application/json");
+        const auto latency = std::chrono::steady_clock::now() - start;
+
+        const bool failed = _is_failure(resp);
+        m_endpoints.report(endpoint_index, latency, !failed);
+        if (!failed)
+        {
+            m_hedger.record_latency(latency);
+        }
         return resp;
     }
 
-    RPCResponse RPCClient::call(const std::string &method_name, const nlohmann::json &parameters)
+    httplib::Result RPCClient::_send_hedged(std::size_t endpoint_index, const std::string &body, std::vector<bool> &tried)
+    {
+        m_hedger.count_request();
+        auto request = std::make_shared<HedgedRequest>();
+        request->body = body;
+        request->tried = tried;
+        request->endpoint_indexes[0] = endpoint_index;
+
+        auto connection = m_endpoints.pool(endpoint_index).acquire();
+        request->clients[0] = &*connection;
+        m_hedger.schedule(std::chrono::steady_clock::now() + m_hedger.delay(), [this, request]()
+                          { _start_hedge(request); });
+
+        const auto start = std::chrono::steady_clock::now();
+        httplib::Result resp = connection->Post("/", body, "application/json");
+        _complete(*request, 0, std::move(resp), std::chrono::steady_clock::now() - start);
+
+        std::unique_lock lock(request->mutex);
+        request->finished.wait(lock, [&request]()
+                               { return request->done; });
+        if (request->started[1])
+        {
+            tried[request->endpoint_indexes[1]] = true;
+        }
+        if (request->winner == 1)
+        {
+            m_hedger.count_hedge_win();
+        }
+        return std::move(*request->results[request->winner]);
+    }
+
+    // Runs on the hedger's timer thread, so it only checks out an idle connection and hands the request over to a thread
+    void RPCClient::_start_hedge(const std::shared_ptr<HedgedRequest> &request)
+    {
+        std::lock_guard lock(request->mutex);
+        if (request->done)
+        {
+            return;
+        }
+        if (std::find(request->tried.begin(), request->tried.end(), false) == request->tried.end())
+        {
+            m_hedger.count_skipped();
+            return;
+        }
+        const std::size_t index = m_endpoints.select(request->tried);
+        auto connection = m_endpoints.pool(index).try_acquire();
+        if (!connection)
+        {
+            m_endpoints.abandon(index);
+            m_hedger.count_skipped();
+            return;
+        }
+
+        request->endpoint_indexes[1] = index;
+        request->clients[1] = &**connection;
+        request->started[1] = true;
+        m_hedger.count_hedge();
+        m_hedger.launch([this, request, connection = std::make_shared<ConnectionPool::Lease>(std::move(*connection))]()
+                        {
+            const auto start = std::chrono::steady_clock::now();
+            httplib::Result resp = (*connection)->Post("/", request->body, "application/json");
+            _complete(*request, 1, std::move(resp), std::chrono::steady_clock::now() - start); });
+    }
+
+    void RPCClient::_complete(HedgedRequest &request, std::size_t slot, httplib::Result resp, std::chrono::steady_clock::duration latency)
+    {
+        const std::size_t other = 1 - slot;
+        const bool failed = _is_failure(resp);
+        bool cancelled;
+        {
+            std::lock_guard lock(request.mutex);
+            cancelled = request.done;
+            request.results[slot] = std::move(resp);
+            request.completed[slot] = true;
+            // A failure only wins once the other copy has failed too or was never sent
+            if (!request.done && (!failed || !request.started[other] || request.completed[other]))
+            {
+                request.done = true;
+                request.winner = slot;
+                if (request.started[other] && !request.completed[other])
+                {
+                    // Its owner holds the connection until it completes, which needs this lock
+                    request.clients[other]->stop();
+                }
+            }
+        }
+        request.finished.notify_all();
+
+        // The copy stopped by the winner says nothing about its endpoint
+        if (cancelled && failed)
+        {
+            return;
+        }
+        m_endpoints.report(request.endpoint_indexes[slot], latency, !failed);
+        if (!failed)
+        {
+            m_hedger.record_latency(latency);
+        }
+    }
+
+    httplib::Result RPCClient::call_raw(const nlohmann::json &payload)
+    {
+        return _post(payload.dump());
+    }
+
+    RPCResponse RPCClient::_parse_response(const nlohmann::json &result_or_error)
+    {
+        if (result_or_error.contains("result"))
+        {
+            return RPCSuccess{result_or_error["result"]};
+        }
+        else if (result_or_error.contains("error"))
+        {
+            return cpp::fail(RPCError{result_or_error["error"]});
+        }
+        else
+        {
+            return cpp::fail(RPCError{"unexpected response: " + result_or_error.dump()});
+        }
+    }
+
+    std::string RPCClient::_request_body(const std::string &method_name, const nlohmann::json &parameters)
     {
         nlohmann::json payload = {
             {"jsonrpc", "2.0"},
             {"id", "dontcare"},
             {"method", method_name},
             {"params", parameters}};
+        return payload.dump();
+    }
+
+    RawResponse RPCClient::_post_request(const std::string &method_name, const std::string &body)
+    {
+        if (!m_single_flight.applies_to(method_name))
+        {
+            return _to_raw(_post(body, m_hedger.applies_to(method_name)));
+        }
+        // The body dumps the parameters with sorted keys, so identical requests have identical bodies
+        return *m_single_flight.run(body, [&]()
+                                    { return _to_raw(_post(body, m_hedger.applies_to(method_name))); });
+    }
+
+    RPCResponse RPCClient::call(const std::string &method_name, const nlohmann::json &parameters)
+    {
+        return _to_response(_post_request(method_name, _request_body(method_name, parameters)));
+    }
+
+    cpp::result<std::string, RPCError> RPCClient::call_unparsed(const std::string &method_name, const nlohmann::json &parameters)
+    {
+        RawResponse resp = _post_request(method_name, _request_body(method_name, parameters));
+        if (resp.error != httplib::Error::Success)
+        {
+            return cpp::fail(RPCError{httplib::to_string(resp.error)});
+        }
+
+        if (resp.status >= 200 && resp.status <= 299)
+        {
+            return std::move(resp.body);
+        }
+        else
+        {
+            return cpp::fail(RPCError{resp.body});
+        }
+    }
+
+    RPCResponse RPCClient::call_serialized(const std::string &body)
+    {
+        return _to_response(_to_raw(_post(body)));
+    }
+
+    RawResponse RPCClient::_to_raw(httplib::Result resp)
+    {
+        if (!resp)
+        {
+            return RawResponse{resp.error(), 0, {}};
+        }
+        return RawResponse{resp.error(), resp->status, std::move(resp->body)};
+    }
+
+    RPCResponse RPCClient::_to_response(const RawResponse &resp)
+    {
+        if (resp.error != httplib::Error::Success)
+        {
+            return cpp::fail(RPCError{httplib::to_string(resp.error)});
+        }
+
+        if (resp.status >= 200 && resp.status <= 299)
+        {
+            // Proxies may answer 2xx with an HTML page or a truncated body
+            const auto result_or_error = nlohmann::json::parse(resp.body, nullptr, false);
+            if (result_or_error.is_discarded())
+            {
+                return cpp::fail(RPCError{"invalid JSON response: " + resp.body});
+            }
+            return _parse_response(result_or_error);
+        }
+        else
+        {
+            return cpp::fail(RPCError{ resp.body });
+        }
+    }
+
+    RPCResponse RPCClient::query(const nlohmann::json &parameters)
+    {
+        if (m_cache.key(parameters).empty())
+        {
+            return call("query", parameters);
+        }
+        auto body = query_unparsed(parameters);
+        if (!body)
+        {
+            return cpp::fail(std::move(body).error());
+        }
+        const auto result_or_error = nlohmann::json::parse(*body, nullptr, false);
+        if (result_or_error.is_discarded())
+        {
+            return cpp::fail(RPCError{"invalid JSON response: " + *body});
+        }
+        return _parse_response(result_or_error);
+    }
+
+    cpp::result<std::string, RPCError> RPCClient::query_unparsed(const nlohmann::json &parameters)
+    {
+        const std::string key = m_cache.key(parameters);
+        std::string body;
+        if (!key.empty() && m_cache.get(key, body))
+        {
+            return body;
+        }
+
+        auto resp = call_unparsed("query", parameters);
+        if (resp)
+        {
+            m_cache.put(key, parameters, *resp);
+        }
+        return resp;
+    }
+
+    RPCClient::BatchOutcome RPCClient::_call_batch_chunk(const std::vector<RPCRequest> &requests, std::size_t begin, std::size_t end,
+                                                         std::vector<RPCResponse> &responses)
+    {
+        nlohmann::json payload = nlohmann::json::array();
+        for (std::size_t index = begin; index < end; index++)
+        {
+            payload.push_back({
+                {"jsonrpc", "2.0"},
+                {"id", index},
+                {"method", requests[index].method_name},
+                {"params", requests[index].parameters}});
+        }
         auto resp = call_raw(payload);
 
         const auto error = resp.error();
         if (error != httplib::Error::Success)
         {
-            return cpp::fail(RPCError{httplib::to_string(error)});
+            for (std::size_t index = begin; index < end; index++)
+            {
+                responses[index] = cpp::fail(RPCError{httplib::to_string(error)});
+            }
+            return BatchOutcome::Answered;
+        }
+        if (_is_failure(resp))
+        {
+            return BatchOutcome::Failed;
         }
 
-        if (resp->status >= 200 && resp->status <= 299)
+        // Endpoints without batch support answer with a single error object or a 4xx status
+        if (resp->status < 200 || resp->status > 299)
         {
-            auto result_or_error = nlohmann::json::parse(resp->body);
-            if (result_or_error.contains("result"))
+            return (resp->status >= 400 && resp->status < 500) ? BatchOutcome::Unsupported : BatchOutcome::Failed;
+        }
+        const auto results = nlohmann::json::parse(resp->body, nullptr, false);
+        if (!results.is_array())
+        {
+            return (results.is_object() && results.contains("error")) ? BatchOutcome::Unsupported : BatchOutcome::Failed;
+        }
+
+        for (const auto &result_or_error : results)
+        {
+            const auto id = result_or_error.find("id");
+            if (id == result_or_error.end() || !id->is_number_unsigned())
             {
-                return RPCSuccess{result_or_error["result"]};
+                continue;
             }
-            else
+            const std::size_t index = id->get<std::size_t>();
+            if (index >= begin && index < end)
             {
-                return cpp::fail(RPCError{result_or_error["error"]});
+                responses[index] = _parse_response(result_or_error);
             }
         }
-        else
+        return BatchOutcome::Answered;
+    }
+
+    void RPCClient::_call_parallel(const std::vector<RPCRequest> &requests, std::size_t begin, std::size_t end,
+                                   std::vector<RPCResponse> &responses)
+    {
+        std::atomic<std::size_t> next_index = begin;
+        const auto worker = [&]()
+        {
+            for (std::size_t index = next_index++; index < end; index = next_index++)
+            {
+                // Workers are raw threads, an exception must end up in the response instead of terminating the process
+                try
+                {
+                    responses[index] = call(requests[index].method_name, requests[index].parameters);
+                }
+                catch (const std::exception &error)
+                {
+                    responses[index] = cpp::fail(RPCError{error.what()});
+                }
+            }
+        };
+
+        const std::size_t workers_amount = std::min(m_endpoints.connections_count(), end - begin);
+        std::vector<std::thread> workers;
+        workers.reserve(workers_amount);
+        for (std::size_t i = 1; i < workers_amount; i++)
         {
-            return cpp::fail(RPCError{ resp->body });
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (auto &thread : workers)
+        {
+            thread.join();
         }
     }
 
-    RPCResponse RPCClient::query(const nlohmann::json &parameters)
+    std::vector<RPCResponse> RPCClient::call_batch(const std::vector<RPCRequest> &requests)
+    {
+        std::vector<RPCResponse> responses(requests.size(), cpp::fail(RPCError{"missing response in batch"}));
+        for (std::size_t begin = 0; begin < requests.size(); begin += m_max_batch_size)
+        {
+            const std::size_t end = std::min(begin + m_max_batch_size, requests.size());
+            if (m_batch_supported)
+            {
+                const BatchOutcome outcome = _call_batch_chunk(requests, begin, end, responses);
+                if (outcome == BatchOutcome::Answered)
+                {
+                    continue;
+                }
+                if (outcome == BatchOutcome::Unsupported)
+                {
+                    m_batch_supported = false;
+                }
+            }
+            _call_parallel(requests, begin, end, responses);
+        }
+        return responses;
+    }
+
+    std::vector<RPCResponse> RPCClient::query_batch(const std::vector<nlohmann::json> &parameters)
+    {
+        std::vector<RPCRequest> requests;
+        requests.reserve(parameters.size());
+        for (const auto &query_parameters : parameters)
+        {
+            requests.push_back(RPCRequest{"query", query_parameters});
+        }
+        return call_batch(requests);
+    }
+
+    ResponseCacheStats RPCClient::cache_stats() const
+    {
+        return m_cache.stats();
+    }
+
+    std::vector<EndpointStats> RPCClient::endpoint_stats() const
+    {
+        return m_endpoints.stats();
+    }
+
+    HedgeStats RPCClient::hedge_stats() const
+    {
+        return m_hedger.stats();
+    }
+
+    SingleFlightStats RPCClient::single_flight_stats() const
+    {
+        return m_single_flight.stats();
+    }
+
+    void RPCClient::clear_cache()
     {
-        return call("query", parameters);
+        m_cache.clear();
     }
 }
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include <ntb/signature_verifier.hpp>
+
+#include <borsh/borsh.hpp>
+#include <ed25519/ed25519.h>
+#include <sha256/sha256.hpp>
+
+extern "C"
+{
+#include <ed25519/batch.h>
+#include <ed25519/ge.h>
+}
+
+namespace ntb
+{
+    namespace
+    {
+        constexpr uint32_t NEP413_TAG = (1u << 31) + 413;
+    }
+
+    // Least recently used public keys are evicted first
+    class SignatureVerifier::PublicKeyCache
+    {
+    private:
+        struct Entry
+        {
+            std::array<uint8_t, 32> public_key;
+            bool valid;
+            ge_p3 negated_point;
+        };
+
+        std::size_t m_capacity;
+        mutable std::mutex m_mutex;
+        // Most recently used first, list nodes never move so the index can view their keys
+        std::list<Entry> m_entries;
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index;
+
+        static std::string_view _key(const std::array<uint8_t, 32> &public_key)
+        {
+            return {reinterpret_cast<const char *>(public_key.data()), public_key.size()};
+        }
+
+    public:
+        explicit PublicKeyCache(std::size_t capacity)
+            : m_capacity(capacity)
+        {
+        }
+
+        // Writes the negated point of `public_key` to `negated_point`, returns false if it is not a valid point
+        bool get(const std::array<uint8_t, 32> &public_key, ge_p3 &negated_point)
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                const auto it = m_index.find(_key(public_key));
+                if (it != m_index.end())
+                {
+                    m_entries.splice(m_entries.begin(), m_entries, it->second);
+                    negated_point = it->second->negated_point;
+                    return it->second->valid;
+                }
+            }
+
+            // Decompressed without the lock, two threads missing the same key both do it once
+            const bool valid = (ge_frombytes_negate_vartime(&negated_point, public_key.data()) == 0);
+            if (m_capacity == 0)
+            {
+                return valid;
+            }
+
+            std::lock_guard lock(m_mutex);
+            if (m_index.find(_key(public_key)) == m_index.end())
+            {
+                m_entries.push_front(Entry{public_key, valid, negated_point});
+                m_index.emplace(_key(m_entries.front().public_key), m_entries.begin());
+                if (m_entries.size() > m_capacity)
+                {
+                    m_index.erase(_key(m_entries.back().public_key));
+                    m_entries.pop_back();
+                }
+            }
+            return valid;
+        }
+
+        std::size_t size() const
+        {
+            std::lock_guard lock(m_mutex);
+            return m_entries.size();
+        }
+    };
+
+    SignatureVerifier::SignatureVerifier(const SignatureVerifierOptions &options)
+        : m_options(options), m_public_keys(std::make_unique<PublicKeyCache>(options.public_key_cache_size))
+    {
+        m_options.batch_size = std::max<std::size_t>(m_options.batch_size, 1);
+    }
+
+    SignatureVerifier::~SignatureVerifier() = default;
+
+    bool SignatureVerifier::verify(const uint8_t *message, std::size_t message_size, const std::array<uint8_t, 64> &signature, const std::array<uint8_t, 32> &public_key) const
+    {
+        bool result = false;
+        const SignatureCheck check{message, message_size, signature, public_key};
+        verify_batch(&check, 1, &result);
+        return result;
+    }
+
+    bool SignatureVerifier::verify_batch(const SignatureCheck *checks, std::size_t count, bool *results) const
+    {
+        const std::size_t batch_size = std::min(m_options.batch_size, count);
+        std::vector<ge_p3> points(batch_size);
+        std::vector<const ge_p3 *> negated_public_keys(batch_size);
+        std::vector<const unsigned char *> signatures(batch_size);
+        std::vector<const unsigned char *> messages(batch_size);
+        std::vector<std::size_t> message_sizes(batch_size);
+        std::vector<const unsigned char *> public_keys(batch_size);
+        std::vector<int> valid(batch_size);
+        bool all_valid = true;
+
+        for (std::size_t begin = 0; begin < count; begin += batch_size)
+        {
+            const std::size_t size = std::min(batch_size, count - begin);
+            for (std::size_t i = 0; i < size; i++)
+            {
+                const SignatureCheck &check = checks[begin + i];
+                negated_public_keys[i] = m_public_keys->get(check.public_key, points[i]) ? &points[i] : nullptr;
+                signatures[i] = check.signature.data();
+                messages[i] = check.message;
+                message_sizes[i] = check.message_size;
+                public_keys[i] = check.public_key.data();
+            }
+
+            ed25519_verify_batch_decompressed(signatures.data(), messages.data(), message_sizes.data(), public_keys.data(), negated_public_keys.data(), size, valid.data());
+            for (std::size_t i = 0; i < size; i++)
+            {
+                results[begin + i] = (valid[i] != 0);
+                all_valid = all_valid && results[begin + i];
+            }
+        }
+        return all_valid;
+    }
+
+    std::vector<bool> SignatureVerifier::verify_batch(const std::vector<SignatureCheck> &checks) const
+    {
+        const std::unique_ptr<bool[]> results(new bool[checks.size()]);
+        verify_batch(checks.data(), checks.size(), results.get());
+        return std::vector<bool>(results.get(), results.get() + checks.size());
+    }
+
+    bool SignatureVerifier::verify_nep413(const schemas::Nep413Payload &payload, const std::array<uint8_t, 64> &signature, const std::array<uint8_t, 32> &public_key) const
+    {
+        const std::array<uint8_t, 32> hash = nep413_payload_hash(payload);
+        return verify(hash.data(), hash.size(), signature, public_key);
+    }
+
+    std::size_t SignatureVerifier::cached_public_keys() const
+    {
+        return m_public_keys->size();
+    }
+
+    std::array<uint8_t, 32> nep413_payload_hash(const schemas::Nep413Payload &payload)
+    {
+        std::vector<uint8_t> bytes;
+        bytes.reserve(64 + payload.message.size() + payload.recipient.size() + (payload.callback_url ? payload.callback_url->size() : 0));
+        BorshEncoder(bytes).Encode(NEP413_TAG, payload);
+
+        sha256::SHA256 hasher;
+        hasher.update(bytes.data(), bytes.size());
+        return hasher.digest();
+    }
+}
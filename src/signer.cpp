@@ -14,6 +14,37 @@ extern "C"
 
 namespace ntb
 {
+    std::array<uint8_t, 64> Signer::sign(const uint8_t *msg, std::size_t msg_size) const
+    {
+        return sign(std::vector<uint8_t>(msg, msg + msg_size));
+    }
+
+    void Signer::sign_batch(const SignerMessage *messages, std::size_t count, std::array<uint8_t, 64> *signatures) const
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            signatures[i] = sign(messages[i].data, messages[i].size);
+        }
+    }
+
+    std::vector<std::array<uint8_t, 64>> Signer::sign_batch(const std::vector<SignerMessage> &messages) const
+    {
+        std::vector<std::array<uint8_t, 64>> signatures(messages.size());
+        sign_batch(messages.data(), messages.size(), signatures.data());
+        return signatures;
+    }
+
+    std::vector<std::array<uint8_t, 64>> Signer::sign_batch(const std::vector<std::vector<uint8_t>> &messages) const
+    {
+        std::vector<SignerMessage> views;
+        views.reserve(messages.size());
+        for (const auto &message : messages)
+        {
+            views.push_back({message.data(), message.size()});
+        }
+        return sign_batch(views);
+    }
+
     ED25519Keypair::ED25519Keypair(const std::string &b58_encoded_private_key_or_seed)
     {
         std::vector<uint8_t> buffer = {};
@@ -75,7 +106,7 @@ namespace ntb
 
     std::string ED25519Keypair::get_public_key_as_b58() const
     {
-        return base58::encode(m_public_key.data(), m_public_key.data() + m_public_key.size());
+        return base58::encode_32(m_public_key.data());
     }
 
     std::array<uint8_t, 32> ED25519Keypair::get_public_key() const
@@ -84,15 +115,39 @@ namespace ntb
     }
 
     std::array<uint8_t, 64> ED25519Keypair::sign(const std::vector<uint8_t> &msg) const
+    {
+        return sign(msg.data(), msg.size());
+    }
+
+    std::array<uint8_t, 64> ED25519Keypair::sign(const uint8_t *msg, std::size_t msg_size) const
     {
         std::array<uint8_t, 64> signature = {};
-        ed25519_sign(signature.data(), msg.data(), msg.size(), m_public_key.data(), m_private_key.data());
+        ed25519_sign(signature.data(), msg, msg_size, m_public_key.data(), m_private_key.data());
         return signature;
     }
 
+    void ED25519Keypair::sign_batch(const SignerMessage *messages, std::size_t count, std::array<uint8_t, 64> *signatures) const
+    {
+        // Below this many messages per chunk, handing work to another thread costs more than signing inline
+        constexpr std::size_t MIN_MESSAGES_PER_CHUNK = 16;
+
+        const std::shared_ptr<ThreadPool> thread_pool = m_thread_pool ? m_thread_pool : ThreadPool::shared();
+        thread_pool->parallel_for(count, MIN_MESSAGES_PER_CHUNK, [&](std::size_t begin, std::size_t end)
+                                  {
+            for (std::size_t i = begin; i < end; i++)
+            {
+                ed25519_sign(signatures[i].data(), messages[i].data, messages[i].size, m_public_key.data(), m_private_key.data());
+            } });
+    }
+
+    void ED25519Keypair::set_thread_pool(std::shared_ptr<ThreadPool> thread_pool)
+    {
+        m_thread_pool = std::move(thread_pool);
+    }
+
     std::string ED25519Keypair::get_private_key_as_b58() const
     {
-        return base58::encode(m_private_key.data(), m_private_key.data() + m_private_key.size());
+        return base58::encode_64(m_private_key.data());
     }
 
     std::array<uint8_t, 64> ED25519Keypair::get_private_key() const
@@ -110,7 +165,7 @@ namespace ntb
     std::string LedgerWallet::get_public_key_as_b58() const
     {
         const auto public_key = get_public_key();
-        return base58::encode(public_key.data(), public_key.data() + public_key.size());
+        return base58::encode_32(public_key.data());
     }
 
     std::array<uint8_t, 32> LedgerWallet::get_public_key() const
@@ -0,0 +1,60 @@
+#include <algorithm>
+
+#include <ntb/single_flight.hpp>
+
+namespace ntb
+{
+    SingleFlight::SingleFlight(const SingleFlightOptions &options)
+        : m_options(options)
+    {
+    }
+
+    bool SingleFlight::applies_to(std::string_view method_name) const
+    {
+        return m_options.enabled && std::find(m_options.methods.begin(), m_options.methods.end(), method_name) != m_options.methods.end();
+    }
+
+    std::shared_ptr<const RawResponse> SingleFlight::run(const std::string &key, const std::function<RawResponse()> &send)
+    {
+        std::promise<std::shared_ptr<const RawResponse>> promise;
+        {
+            std::unique_lock lock(m_mutex);
+            m_stats.requests++;
+            const auto it = m_in_flight.find(key);
+            if (it != m_in_flight.end())
+            {
+                m_stats.coalesced++;
+                const std::shared_future<std::shared_ptr<const RawResponse>> response = it->second;
+                lock.unlock();
+                return response.get();
+            }
+            m_in_flight.emplace(key, promise.get_future().share());
+        }
+
+        // Removed before the waiters are woken up, requests arriving from then on are sent again
+        const auto finish = [this, &key]()
+        {
+            std::lock_guard lock(m_mutex);
+            m_in_flight.erase(key);
+        };
+        try
+        {
+            auto response = std::make_shared<const RawResponse>(send());
+            finish();
+            promise.set_value(response);
+            return response;
+        }
+        catch (...)
+        {
+            finish();
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+    SingleFlightStats SingleFlight::stats() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_stats;
+    }
+}
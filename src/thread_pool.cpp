@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+#include <ntb/thread_pool.hpp>
+
+namespace ntb
+{
+    namespace
+    {
+        struct ParallelForState
+        {
+            std::size_t count;
+            std::size_t chunk_size;
+            std::size_t chunks_count;
+            std::atomic<std::size_t> next_chunk = 0;
+            std::mutex mutex;
+            std::condition_variable done;
+            std::size_t completed_chunks = 0;
+            std::exception_ptr error;
+        };
+
+        // Runs chunks until none are left, the state outlives `func` only once every chunk is completed
+        void run_chunks(ParallelForState &state, const std::function<void(std::size_t, std::size_t)> &func)
+        {
+            for (std::size_t chunk = state.next_chunk++; chunk < state.chunks_count; chunk = state.next_chunk++)
+            {
+                const std::size_t begin = chunk * state.chunk_size;
+                const std::size_t end = std::min(begin + state.chunk_size, state.count);
+                std::exception_ptr error;
+                try
+                {
+                    func(begin, end);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+
+                std::lock_guard lock(state.mutex);
+                if (error && !state.error)
+                {
+                    state.error = error;
+                }
+                if (++state.completed_chunks == state.chunks_count)
+                {
+                    state.done.notify_all();
+                }
+            }
+        }
+    }
+
+    ThreadPool::ThreadPool(std::size_t threads_count)
+    {
+        if (threads_count == 0)
+        {
+            threads_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        }
+        m_workers.reserve(threads_count);
+        for (std::size_t i = 0; i < threads_count; i++)
+        {
+            m_workers.emplace_back(&ThreadPool::_worker_loop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_task_available.notify_all();
+        for (std::thread &worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    std::shared_ptr<ThreadPool> ThreadPool::shared()
+    {
+        static const std::shared_ptr<ThreadPool> pool = std::make_shared<ThreadPool>();
+        return pool;
+    }
+
+    void ThreadPool::_worker_loop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(m_mutex);
+                m_task_available.wait(lock, [this]()
+                                      { return m_stopping || !m_tasks.empty(); });
+                if (m_tasks.empty())
+                {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    void ThreadPool::parallel_for(std::size_t count, std::size_t min_chunk_size, const std::function<void(std::size_t, std::size_t)> &func)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        min_chunk_size = std::max<std::size_t>(min_chunk_size, 1);
+        // A few chunks per thread so a slow worker does not hold the whole batch back
+        const std::size_t target_chunks = (m_workers.size() + 1) * 4;
+        const std::size_t chunk_size = std::max(min_chunk_size, (count + target_chunks - 1) / target_chunks);
+        const std::size_t chunks_count = (count + chunk_size - 1) / chunk_size;
+        if (chunks_count == 1)
+        {
+            func(0, count);
+            return;
+        }
+
+        auto state = std::make_shared<ParallelForState>();
+        state->count = count;
+        state->chunk_size = chunk_size;
+        state->chunks_count = chunks_count;
+
+        // Helpers that only start after every chunk is taken return immediately, so the caller never waits on them.
+        // This keeps nested calls from a worker thread from deadlocking
+        const std::size_t helpers_count = std::min(m_workers.size(), chunks_count - 1);
+        {
+            std::lock_guard lock(m_mutex);
+            for (std::size_t i = 0; i < helpers_count; i++)
+            {
+                m_tasks.emplace_back([state, &func]()
+                                     { run_chunks(*state, func); });
+            }
+        }
+        m_task_available.notify_all();
+
+        run_chunks(*state, func);
+
+        std::unique_lock lock(state->mutex);
+        state->done.wait(lock, [&state]()
+                         { return state->completed_chunks == state->chunks_count; });
+        if (state->error)
+        {
+            std::rethrow_exception(state->error);
+        }
+    }
+
+    std::size_t ThreadPool::size() const
+    {
+        return m_workers.size();
+    }
+}
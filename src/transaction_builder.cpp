@@ -0,0 +1,59 @@
+#include <ntb/transaction_builder.hpp>
+
+#include "base58/base64.hpp"
+#include "borsh/borsh.hpp"
+#include "sha256/sha256.hpp"
+
+namespace ntb
+{
+    namespace
+    {
+        constexpr std::string_view RPC_BODY_PREFIX = R"({"jsonrpc":"2.0","id":"dontcare","method":")";
+        constexpr std::string_view RPC_BODY_PARAMS = R"(","params":[")";
+        constexpr std::string_view RPC_BODY_SUFFIX = R"("]})";
+    }
+
+    TransactionBuilder &TransactionBuilder::for_current_thread()
+    {
+        thread_local TransactionBuilder builder;
+        return builder;
+    }
+
+    void TransactionBuilder::build(const Signer &signer, const std::string &signer_id, const std::array<uint8_t, 32> &public_key, uint64_t nonce,
+                                   const std::string &receiver_id, const std::array<uint8_t, 32> &block_hash,
+                                   const std::vector<schemas::Action> &actions)
+    {
+        // Same layout as schemas::Transaction, encoded from the caller's objects instead of copies of them
+        m_signed_transaction.clear();
+        BorshEncoder encoder(m_signed_transaction);
+        encoder.Encode(signer_id, schemas::PublicKey{schemas::ED25519PublicKey{public_key}}, nonce, receiver_id, block_hash, actions);
+
+        sha256::SHA256 hasher;
+        hasher.update(m_signed_transaction.data(), m_signed_transaction.size());
+        m_hash = hasher.digest();
+
+        encoder.Encode(schemas::Signature{schemas::KeyType::ED25519, signer.sign(m_hash.data(), m_hash.size())});
+    }
+
+    const std::string &TransactionBuilder::rpc_body(std::string_view method_name)
+    {
+        const std::size_t base64_size = base64::encoded_size(m_signed_transaction.size());
+        m_rpc_body.clear();
+        m_rpc_body.append(RPC_BODY_PREFIX).append(method_name).append(RPC_BODY_PARAMS);
+        const std::size_t base64_offset = m_rpc_body.size();
+        m_rpc_body.resize(base64_offset + base64_size);
+        base64::encode(m_signed_transaction.data(), m_signed_transaction.size(), m_rpc_body.data() + base64_offset);
+        m_rpc_body.append(RPC_BODY_SUFFIX);
+        return m_rpc_body;
+    }
+
+    const std::vector<uint8_t> &TransactionBuilder::signed_transaction() const
+    {
+        return m_signed_transaction;
+    }
+
+    const std::array<uint8_t, 32> &TransactionBuilder::hash() const
+    {
+        return m_hash;
+    }
+}
@@ -0,0 +1,89 @@
+#include <algorithm>
+
+#include <ntb/schemas.hpp>
+#include <ntb/transaction_template.hpp>
+
+#include "borsh/borsh.hpp"
+
+namespace ntb
+{
+    namespace
+    {
+        constexpr uint8_t FUNCTION_CALL_ACTION_INDEX = 2;
+        static_assert(std::is_same_v<std::variant_alternative_t<FUNCTION_CALL_ACTION_INDEX, schemas::Action>, schemas::FunctionCall>);
+
+        void append(std::vector<uint8_t> &bytes, const uint8_t *data, std::size_t size)
+        {
+            const std::size_t offset = bytes.size();
+            bytes.resize(offset + size);
+            std::copy(data, data + size, bytes.begin() + offset);
+        }
+    }
+
+    TransactionTemplate::TransactionTemplate(const std::string &signer_id, const std::string &receiver_id, const std::string &method_name)
+        : m_signer_id(signer_id), m_receiver_id(receiver_id), m_method_name(method_name)
+    {
+        BorshEncoder(m_receiver_segment).Encode(m_receiver_id);
+        BorshEncoder(m_action_segment).Encode(static_cast<uint32_t>(1), FUNCTION_CALL_ACTION_INDEX, m_method_name);
+    }
+
+    const std::string &TransactionTemplate::signer_id() const
+    {
+        return m_signer_id;
+    }
+
+    const std::string &TransactionTemplate::receiver_id() const
+    {
+        return m_receiver_id;
+    }
+
+    const std::string &TransactionTemplate::method_name() const
+    {
+        return m_method_name;
+    }
+
+    const TransactionTemplate::KeyPrefix &TransactionTemplate::_prefix(const std::array<uint8_t, 32> &public_key) const
+    {
+        std::lock_guard lock(m_prefixes_mutex);
+        for (const auto &prefix : m_prefixes)
+        {
+            if (prefix->public_key == public_key)
+            {
+                return *prefix;
+            }
+        }
+
+        auto prefix = std::make_unique<KeyPrefix>();
+        prefix->public_key = public_key;
+        BorshEncoder(prefix->bytes).Encode(m_signer_id, schemas::PublicKey{schemas::ED25519PublicKey{public_key}});
+        prefix->midstate.update(prefix->bytes.data(), prefix->bytes.size());
+        m_prefixes.push_back(std::move(prefix));
+        return *m_prefixes.back();
+    }
+
+    void TransactionTemplate::build(TransactionBuilder &builder, const Signer &signer, const std::array<uint8_t, 32> &public_key, uint64_t nonce,
+                                    const std::array<uint8_t, 32> &block_hash, const uint8_t *args, std::size_t args_size, uint64_t gas,
+                                    const uint128 &deposit) const
+    {
+        const KeyPrefix &prefix = _prefix(public_key);
+
+        std::vector<uint8_t> &bytes = builder.m_signed_transaction;
+        bytes.clear();
+        append(bytes, prefix.bytes.data(), prefix.bytes.size());
+        BorshEncoder encoder(bytes);
+        encoder.Encode(nonce);
+        append(bytes, m_receiver_segment.data(), m_receiver_segment.size());
+        encoder.Encode(block_hash);
+        append(bytes, m_action_segment.data(), m_action_segment.size());
+        encoder.Encode(static_cast<uint32_t>(args_size));
+        append(bytes, args, args_size);
+        encoder.Encode(gas, deposit);
+
+        // The cached state has already absorbed the prefix, only the bytes after it still need hashing
+        sha256::SHA256 hasher = prefix.midstate;
+        hasher.update(bytes.data() + prefix.bytes.size(), bytes.size() - prefix.bytes.size());
+        builder.m_hash = hasher.digest();
+
+        encoder.Encode(schemas::Signature{schemas::KeyType::ED25519, signer.sign(builder.m_hash.data(), builder.m_hash.size())});
+    }
+}
@@ -0,0 +1,175 @@
+#include <algorithm>
+
+#include <ntb/transaction_tracker.hpp>
+
+namespace ntb
+{
+    namespace
+    {
+        constexpr std::array<std::string_view, 5> TX_FINALITY_NAMES = {
+            "INCLUDED", "EXECUTED_OPTIMISTIC", "INCLUDED_FINAL", "EXECUTED", "FINAL"};
+    }
+
+    std::string_view tx_finality_to_string(TxFinality finality)
+    {
+        return TX_FINALITY_NAMES[static_cast<std::size_t>(finality)];
+    }
+
+    TransactionTracker::TransactionTracker(RPCClient &rpc, const TransactionTrackerOptions &options)
+        : m_rpc(rpc), m_options(options)
+    {
+    }
+
+    TransactionTracker::~TransactionTracker()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wakeup.notify_all();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    void TransactionTracker::track(const std::string &tx_hash, const std::string &sender_id, TxFinality finality, Callback callback)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_stopping)
+            {
+                throw std::runtime_error("TransactionTracker is stopping");
+            }
+            m_pending.push_back(PendingTransaction{
+                tx_hash, sender_id, finality, std::chrono::steady_clock::now() + m_options.timeout, std::move(callback)});
+            if (!m_thread.joinable())
+            {
+                m_thread = std::thread(&TransactionTracker::_run, this);
+            }
+        }
+        m_wakeup.notify_all();
+    }
+
+    std::future<RPCResponse> TransactionTracker::track(const std::string &tx_hash, const std::string &sender_id, TxFinality finality)
+    {
+        auto outcome = std::make_shared<std::promise<RPCResponse>>();
+        std::future<RPCResponse> future = outcome->get_future();
+        track(tx_hash, sender_id, finality, [outcome](RPCResponse response)
+              { outcome->set_value(std::move(response)); });
+        return future;
+    }
+
+    std::size_t TransactionTracker::pending() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_pending.size();
+    }
+
+    void TransactionTracker::_run()
+    {
+        std::unique_lock lock(m_mutex);
+        while (!m_stopping)
+        {
+            if (m_pending.empty())
+            {
+                m_wakeup.wait(lock, [this]()
+                              { return m_stopping || !m_pending.empty(); });
+                continue;
+            }
+
+            std::vector<PendingTransaction> polling = std::move(m_pending);
+            m_pending.clear();
+            lock.unlock();
+            _poll(polling);
+            lock.lock();
+            m_pending.insert(m_pending.end(), std::make_move_iterator(polling.begin()), std::make_move_iterator(polling.end()));
+
+            m_wakeup.wait_for(lock, m_options.poll_interval, [this]()
+                              { return m_stopping; });
+        }
+
+        std::vector<PendingTransaction> abandoned = std::move(m_pending);
+        m_pending.clear();
+        lock.unlock();
+        for (auto &transaction : abandoned)
+        {
+            transaction.callback(cpp::fail(RPCError{"TransactionTracker stopped before the transaction reached the requested finality"}));
+        }
+    }
+
+    void TransactionTracker::_poll(std::vector<PendingTransaction> &pending)
+    {
+        const std::string method_name = m_options.use_experimental_tx_status ? "EXPERIMENTAL_tx_status" : "tx";
+        std::vector<RPCRequest> requests;
+        requests.reserve(pending.size());
+        for (const auto &transaction : pending)
+        {
+            requests.push_back(RPCRequest{
+                method_name,
+                {{"tx_hash", transaction.hash},
+                 {"sender_account_id", transaction.sender_id},
+                 {"wait_until", "NONE"}}});
+        }
+        std::vector<RPCResponse> responses;
+        try
+        {
+            responses = m_rpc.call_batch(requests);
+        }
+        catch (const std::exception &error)
+        {
+            // Must not escape the tracker thread, the string error is transient so the batch is polled again
+            responses = std::vector<RPCResponse>(pending.size(), cpp::fail(RPCError{error.what()}));
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        std::vector<PendingTransaction> still_pending;
+        for (std::size_t index = 0; index < pending.size(); index++)
+        {
+            PendingTransaction &transaction = pending[index];
+            RPCResponse &response = responses[index];
+            const bool resolved = (response.has_value() && _reached_finality(response.value().data, transaction.finality))
+                || (response.has_error() && !_is_transient_error(response.error()));
+            if (resolved)
+            {
+                transaction.callback(std::move(response));
+            }
+            else if (now >= transaction.deadline)
+            {
+                transaction.callback(cpp::fail(RPCError{"timed out waiting for transaction " + transaction.hash}));
+            }
+            else
+            {
+                still_pending.push_back(std::move(transaction));
+            }
+        }
+        pending = std::move(still_pending);
+    }
+
+    bool TransactionTracker::_reached_finality(const nlohmann::json &outcome, TxFinality finality)
+    {
+        const auto status = outcome.find("final_execution_status");
+        if (status == outcome.end() || !status->is_string())
+        {
+            // Nodes without TxExecutionStatus only answer once the transaction is executed
+            return outcome.contains("status") && finality <= TxFinality::Executed;
+        }
+        const auto name = std::find(TX_FINALITY_NAMES.begin(), TX_FINALITY_NAMES.end(), status->get<std::string>());
+        if (name == TX_FINALITY_NAMES.end())
+        {
+            return false; // "NONE"
+        }
+        return static_cast<std::size_t>(name - TX_FINALITY_NAMES.begin()) >= static_cast<std::size_t>(finality);
+    }
+
+    bool TransactionTracker::_is_transient_error(const RPCError &error)
+    {
+        if (!error.data.is_object())
+        {
+            return true; // transport error, retried on next poll
+        }
+        const std::string name = error.data.value("name", "");
+        const std::string cause = error.data.contains("cause") ? error.data["cause"].value("name", "") : "";
+        return name == "TIMEOUT_ERROR" || cause == "TIMEOUT_ERROR" || cause == "UNKNOWN_TRANSACTION";
+    }
+}
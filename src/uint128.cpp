@@ -0,0 +1,70 @@
+#include <algorithm>
+
+#include <ntb/uint128.hpp>
+
+namespace ntb
+{
+    namespace
+    {
+        constexpr uint32_t DECIMAL_CHUNK = 1000000000; // 10^9, the largest power of ten below 2^32
+        constexpr uint32_t DECIMAL_CHUNK_DIGITS = 9;
+        constexpr std::pair<uint128, uint32_t> MAX_DIVMOD_TEN = uint128::max().divmod(10);
+    }
+
+    std::optional<uint128> uint128::from_string(std::string_view decimal)
+    {
+        if (decimal.empty())
+        {
+            return std::nullopt;
+        }
+        uint128 value;
+        for (const char digit : decimal)
+        {
+            if (digit < '0' || digit > '9')
+            {
+                return std::nullopt;
+            }
+            const uint32_t digit_value = static_cast<uint32_t>(digit - '0');
+            if (value > MAX_DIVMOD_TEN.first || (value == MAX_DIVMOD_TEN.first && digit_value > MAX_DIVMOD_TEN.second))
+            {
+                return std::nullopt;
+            }
+            value = value * 10 + digit_value;
+        }
+        return value;
+    }
+
+    char *uint128::to_chars(char *first, char *last) const
+    {
+        char digits[MAX_DECIMAL_DIGITS];
+        std::size_t length = 0;
+        uint128 remaining = *this;
+        do
+        {
+            auto [quotient, chunk] = remaining.divmod(DECIMAL_CHUNK);
+            for (uint32_t i = 0; i < DECIMAL_CHUNK_DIGITS && (chunk != 0 || !quotient.is_zero()); i++)
+            {
+                digits[length++] = static_cast<char>('0' + chunk % 10);
+                chunk /= 10;
+            }
+            remaining = quotient;
+        } while (!remaining.is_zero());
+
+        if (length == 0)
+        {
+            digits[length++] = '0';
+        }
+        if (static_cast<std::size_t>(last - first) < length)
+        {
+            return nullptr;
+        }
+        return std::reverse_copy(digits, digits + length, first);
+    }
+
+    std::string uint128::to_string() const
+    {
+        char digits[MAX_DECIMAL_DIGITS];
+        const char *end = to_chars(digits, digits + MAX_DECIMAL_DIGITS);
+        return std::string(digits, end - digits);
+    }
+}
@@ -0,0 +1,233 @@
+#include <ntb/view_result.hpp>
+
+namespace ntb
+{
+    namespace
+    {
+        // Walks just enough of the JSON structure to find nested keys, values it is not interested in are skipped over unparsed
+        class Scanner
+        {
+        private:
+            std::string_view m_body;
+            std::size_t m_position = 0;
+
+            bool _at(char c) const
+            {
+                return m_position < m_body.size() && m_body[m_position] == c;
+            }
+
+            bool _skip_string()
+            {
+                for (m_position++; m_position < m_body.size(); m_position++)
+                {
+                    if (m_body[m_position] == '\\')
+                    {
+                        m_position++;
+                    }
+                    else if (m_body[m_position] == '"')
+                    {
+                        m_position++;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool _skip_value()
+            {
+                if (_at('"'))
+                {
+                    return _skip_string();
+                }
+                if (_at('{') || _at('['))
+                {
+                    std::size_t depth = 0;
+                    while (m_position < m_body.size())
+                    {
+                        const char c = m_body[m_position];
+                        if (c == '"')
+                        {
+                            if (!_skip_string())
+                            {
+                                return false;
+                            }
+                            continue;
+                        }
+                        m_position++;
+                        if (c == '{' || c == '[')
+                        {
+                            depth++;
+                        }
+                        else if ((c == '}' || c == ']') && --depth == 0)
+                        {
+                            return true;
+                        }
+                    }
+                    return false;
+                }
+                // Number or literal
+                const std::size_t start = m_position;
+                while (m_position < m_body.size() && m_body[m_position] != ',' && m_body[m_position] != '}' && m_body[m_position] != ']' && !_is_space(m_body[m_position]))
+                {
+                    m_position++;
+                }
+                return m_position != start;
+            }
+
+            static bool _is_space(char c)
+            {
+                return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+            }
+
+        public:
+            explicit Scanner(std::string_view body)
+                : m_body(body)
+            {
+            }
+
+            void skip_spaces()
+            {
+                while (m_position < m_body.size() && _is_space(m_body[m_position]))
+                {
+                    m_position++;
+                }
+            }
+
+            // Moves to the value of `key` in the object starting at the current position
+            bool enter_key(std::string_view key)
+            {
+                skip_spaces();
+                if (!_at('{'))
+                {
+                    return false;
+                }
+                m_position++;
+                while (true)
+                {
+                    skip_spaces();
+                    if (!_at('"'))
+                    {
+                        return false;
+                    }
+                    const std::size_t key_start = m_position + 1;
+                    if (!_skip_string())
+                    {
+                        return false;
+                    }
+                    const std::string_view current_key = m_body.substr(key_start, m_position - key_start - 1);
+                    skip_spaces();
+                    if (!_at(':'))
+                    {
+                        return false;
+                    }
+                    m_position++;
+                    skip_spaces();
+                    if (current_key == key)
+                    {
+                        return true;
+                    }
+                    if (!_skip_value())
+                    {
+                        return false;
+                    }
+                    skip_spaces();
+                    if (!_at(','))
+                    {
+                        return false;
+                    }
+                    m_position++;
+                }
+            }
+
+            bool read_uint64(uint64_t &value)
+            {
+                const std::size_t digits_start = m_position;
+                value = 0;
+                while (m_position < m_body.size() && m_body[m_position] >= '0' && m_body[m_position] <= '9')
+                {
+                    const uint64_t digit = static_cast<uint64_t>(m_body[m_position] - '0');
+                    if (value > (UINT64_MAX - digit) / 10)
+                    {
+                        return false;
+                    }
+                    value = value * 10 + digit;
+                    m_position++;
+                }
+                return m_position != digits_start;
+            }
+
+            // Appends an array of integers in [0, 255] starting at the current position
+            bool read_bytes(std::vector<uint8_t> &out)
+            {
+                if (!_at('['))
+                {
+                    return false;
+                }
+                m_position++;
+                // Numbers take at least two characters with their separator
+                const std::size_t end = m_body.find(']', m_position);
+                if (end == std::string_view::npos)
+                {
+                    return false;
+                }
+                out.reserve(out.size() + (end - m_position + 1) / 2);
+
+                skip_spaces();
+                if (_at(']'))
+                {
+                    return true;
+                }
+                while (true)
+                {
+                    unsigned int value = 0;
+                    const std::size_t digits_start = m_position;
+                    while (m_position < m_body.size() && m_body[m_position] >= '0' && m_body[m_position] <= '9' && value <= 255)
+                    {
+                        value = value * 10 + static_cast<unsigned int>(m_body[m_position] - '0');
+                        m_position++;
+                    }
+                    if (m_position == digits_start || value > 255)
+                    {
+                        return false;
+                    }
+                    out.push_back(static_cast<uint8_t>(value));
+
+                    skip_spaces();
+                    if (_at(']'))
+                    {
+                        return true;
+                    }
+                    if (!_at(','))
+                    {
+                        return false;
+                    }
+                    m_position++;
+                    skip_spaces();
+                }
+            }
+        };
+    }
+
+    bool scan_view_result(std::string_view body, std::vector<uint8_t> &out)
+    {
+        const std::size_t initial_size = out.size();
+        Scanner scanner(body);
+        if (scanner.enter_key("result") && scanner.enter_key("result") && scanner.read_bytes(out))
+        {
+            return true;
+        }
+        out.resize(initial_size);
+        return false;
+    }
+
+    bool scan_query_block_height(std::string_view body, uint64_t &block_height)
+    {
+        Scanner error_scanner(body);
+        if (error_scanner.enter_key("result") && error_scanner.enter_key("error"))
+        {
+            return false;
+        }
+        Scanner scanner(body);
+        return scanner.enter_key("result") && scanner.enter_key("block_height") && scanner.read_uint64(block_height);
+    }
+}